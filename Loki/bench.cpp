@@ -82,6 +82,8 @@ namespace Bench {
         SearchInfo_t* info = new SearchInfo_t();
 
         long total_nodes = 0;
+        TT_Stats tt_stats;
+        EvalTable_Stats eval_stats;
 
         long long start, end;
         long long total_time = 0;
@@ -101,6 +103,8 @@ namespace Bench {
             // Step 2C. Save the node-count and time
             total_nodes += info->nodes;
             total_time += end - start;
+            tt_stats += info->tt_stats;
+            eval_stats += info->eval_stats;
 
             long long duration = end - start;
             long long nps = info->nodes / (((duration <= 0) ? 1 : duration) / 1000.0);
@@ -118,7 +122,16 @@ namespace Bench {
             "\n======================\n" <<
             "Time spent        " << total_time << "\n" <<
             "Nodes             " << total_nodes << "\n" <<
-            "nps               " << total_nodes / (total_time / 1000) << std::endl;
+            "nps               " << total_nodes / (total_time / 1000) << "\n" <<
+            "TT probes         " << tt_stats.probes << "\n" <<
+            "TT hit rate       " << ((tt_stats.probes == 0) ? 0.0 : 100.0 * double(tt_stats.hits) / double(tt_stats.probes)) << "%\n" <<
+            "TT cutoffs        " << tt_stats.cutoffs << "\n" <<
+            "TT occupied miss  " << tt_stats.occupied_misses << "\n" <<
+            "TT stores         " << "same " << tt_stats.stores_same << ", skipped " << tt_stats.stores_skipped
+                << ", empty " << tt_stats.stores_empty << ", replaced " << tt_stats.stores_replaced << "\n" <<
+            "TT hashfull       " << tt->hashfull() << "\n" <<
+            "Eval hash probes  " << eval_stats.probes << "\n" <<
+            "Eval hash hits    " << ((eval_stats.probes == 0) ? 0.0 : 100.0 * double(eval_stats.hits) / double(eval_stats.probes)) << "%" << std::endl;
         
     }
 
@@ -19,54 +19,13 @@
 
 #include <random>
 
-Bitboard BBS::knight_attacks[64] = { 0 };
-
-void BBS::init_knightAttacks() {
-	Bitboard knightAttackBrd = 0;
-
-	// We'll loop through all squares and add knight attacks as if it was an empty board.
-	for (int sq = 0; sq < 64; sq++) {
-		knightAttackBrd = 0;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~FileMasks8[FILE_H]) << 17;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~FileMasks8[FILE_A]) << 15;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~(FileMasks8[FILE_G] | FileMasks8[FILE_H])) << 10;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~(FileMasks8[FILE_G] | FileMasks8[FILE_H])) >> 6;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~FileMasks8[FILE_H]) >> 15;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~FileMasks8[FILE_A]) >> 17;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~(FileMasks8[FILE_A] | FileMasks8[FILE_B])) << 6;
-		knightAttackBrd |= ((uint64_t(1) << sq) & ~(FileMasks8[FILE_A] | FileMasks8[FILE_B])) >> 10;
-
-		knight_attacks[sq] = knightAttackBrd;
-	}
-
-}
-
-
-Bitboard BBS::king_attacks[64] = { 0 };
-
-void BBS::init_kingAttacks() {
-	Bitboard attackBrd = 0;
-
-	for (int sq = 0; sq < 64; sq++) {
-		attackBrd = 0;
-		Bitboard sqBrd = uint64_t(1) << sq;
-
-		attackBrd |= (sqBrd & ~RankMasks8[RANK_8]) << 8;
-		attackBrd |= (sqBrd & ~RankMasks8[RANK_1]) >> 8;
-		attackBrd |= (sqBrd & ~FileMasks8[FILE_H]) << 1;
-		attackBrd |= (sqBrd & ~FileMasks8[FILE_A]) >> 1;
-
-		attackBrd |= (sqBrd & ~(RankMasks8[RANK_8] | FileMasks8[FILE_A])) << 7;
-		attackBrd |= (sqBrd & ~(RankMasks8[RANK_8] | FileMasks8[FILE_H])) << 9;
-		attackBrd |= (sqBrd & ~(RankMasks8[RANK_1] | FileMasks8[FILE_A])) >> 9;
-		attackBrd |= (sqBrd & ~(RankMasks8[RANK_1] | FileMasks8[FILE_H])) >> 7;
-
-
-
-		king_attacks[sq] = attackBrd;
-	}
-}
-
+#if defined(HAS_PEXT) && !defined(USE_PEXT)
+#if defined(_MSC_VER)
+#include <intrin.h> // Used for __cpuidex
+#else
+#include <cpuid.h>
+#endif
+#endif
 
 Bitboard BBS::Zobrist::piece_keys[2][6][64] = { {{0}} };
 Bitboard BBS::Zobrist::empty_keys[64] = { 0 };
@@ -98,170 +57,162 @@ void BBS::Zobrist::init_zobrist() {
 }
 
 
+uint64_t BBS::Zobrist::version_stamp() {
+	uint64_t stamp = 0;
 
-Bitboard BBS::EvalBitMasks::passed_pawn_masks[2][64] = { {0} };
-Bitboard BBS::EvalBitMasks::isolated_bitmasks[8] = { 0 };
-Bitboard BBS::EvalBitMasks::outpost_masks[2][64] = { {0} };
-Bitboard BBS::EvalBitMasks::rear_span_masks[2][64] = { {0} };
-Bitboard BBS::EvalBitMasks::backwards_masks[2][64] = { {0} };
-Bitboard BBS::EvalBitMasks::outer_kingring[64] = { 0 };
-
-void BBS::EvalBitMasks::initBitMasks() {
-	Bitboard bitmask = 0;
-	/*
-	Passed pawn bitmasks
-	*/
-	for (int sq = 0; sq < 64; sq++) {
-		bitmask = 0;
-
-		int r = sq / 8;
-		int f = sq % 8;
+	// Rotate between each key such that two keys swapping places also changes the stamp.
+	auto fold = [&stamp](uint64_t key) { stamp = ((stamp << 7) | (stamp >> 57)) ^ key; };
 
-
-		Bitboard flankmask = 0;
-
-		flankmask |= FileMasks8[f];
-
-		if (f > FILE_A) {
-			flankmask |= FileMasks8[f - 1];
-		}
-		if (f < FILE_H) {
-			flankmask |= FileMasks8[f + 1];
-		}
-
-		// Create the bitmask for the white pawns
-		for (int i = r + 1; i <= RANK_8; i++) {
-			bitmask |= (flankmask & RankMasks8[i]);
+	for (int c = WHITE; c <= BLACK; c++) {
+		for (int pce = PAWN; pce < NO_TYPE; pce++) {
+			for (int sq = 0; sq < 64; sq++) {
+				fold(piece_keys[c][pce][sq]);
+			}
 		}
-		passed_pawn_masks[WHITE][sq] = bitmask;
+	}
 
-		// Now do it for the black ones.
-		bitmask = 0;
-		for (int i = r - 1; i >= RANK_1; i--) {
-			bitmask |= (flankmask & RankMasks8[i]);
-		}
-		passed_pawn_masks[BLACK][sq] = bitmask;
+	for (int sq = 0; sq < 64; sq++) {
+		fold(empty_keys[sq]);
 	}
 
+	fold(side_key);
 
+	for (int c = 0; c < 16; c++) {
+		fold(castling_keys[c]);
+	}
 
-	/*
-	Isolated bitmasks
-	*/
-	
-	for (int f = FILE_A; f <= FILE_H; f++) {
-		bitmask = 0;
+	return stamp;
+}
 
-		// If a pawn is isolated, there are no pawns on the files directly next to it.
-		// We shouln't include the file that the pawn is on itself, since we'd not be able to recognize it as isolated if it were doubled.
-		bitmask = ((f > FILE_A) ? FileMasks8[f - 1] : 0) | ((f < FILE_H) ? FileMasks8[f + 1] : 0);
 
-		isolated_bitmasks[f] = bitmask;
-	}
 
-	/*
-	
-	Outpost masks -> these can just be made by AND'ing the isolated bitmasks and passed pawn bitmasks.
-	
-	*/
-	for (int sq = 0; sq < 64; sq++) {
+void BBS::INIT() {
+	Zobrist::init_zobrist();
+}
 
-		outpost_masks[WHITE][sq] = (passed_pawn_masks[WHITE][sq] & isolated_bitmasks[sq % 8]);
-		outpost_masks[BLACK][sq] = (passed_pawn_masks[BLACK][sq] & isolated_bitmasks[sq % 8]);
 
-	}
 
+void Magics::INIT() {
+	backend = pext_available() ? PEXT : MAGIC;
 
-	/*
-	
-	Rearspan bitmasks. The squares behind pawns.
-	
-	*/
+	_initialize_slider_tables(true);
+	_initialize_slider_tables(false);
+}
 
-	for (int sq = 0; sq < 64; sq++) {
-		rear_span_masks[WHITE][sq] = (passed_pawn_masks[BLACK][sq] & BBS::FileMasks8[sq % 8]);
-		rear_span_masks[BLACK][sq] = (passed_pawn_masks[WHITE][sq] & BBS::FileMasks8[sq % 8]);
-	}
 
 
-	/*
-	
-	Backwards bitmasks. These are the squares on the current rank and all others behind it, on the adjacent files if a square.
-	
-	*/
+namespace Magics {
 
-	for (int sq = 0; sq < 64; sq++) {
+#if defined(USE_PEXT)
+	Backend backend = PEXT;
+#else
+	Backend backend = MAGIC;
+#endif
 
-		backwards_masks[WHITE][sq] = (passed_pawn_masks[BLACK][sq] & ~BBS::FileMasks8[sq % 8]);
-		backwards_masks[BLACK][sq] = (passed_pawn_masks[WHITE][sq] & ~BBS::FileMasks8[sq % 8]);
 
-		if (sq % 8 != FILE_H) {
-			backwards_masks[WHITE][sq] |= (uint64_t(1) << (sq + 1));
-			backwards_masks[BLACK][sq] |= (uint64_t(1) << (sq + 1));
-		}
-		if (sq % 8 != FILE_A) {
-			backwards_masks[WHITE][sq] |= (uint64_t(1) << (sq - 1));
-			backwards_masks[BLACK][sq] |= (uint64_t(1) << (sq - 1));
+#if defined(HAS_PEXT) && !defined(USE_PEXT)
+	namespace {
+		void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+			__cpuidex(reinterpret_cast<int*>(regs), int(leaf), int(subleaf));
+#else
+			__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
 		}
 	}
+#endif
 
 
-	/*
-	
-	Outer king-rings. These are just the 16 squares on the outside of the ring, that the king would be able to move to on an empty board.
-	
-	*/
-	for (int sq = 0; sq < 64; sq++) {
-
-		Bitboard ring = 0;
-		int rnk = sq / 8;
-		int fl = sq % 8;
+	/// <summary>
+	/// Determine if the PEXT backend can be used. If it has been forced at compile time, it is always used. Otherwise the CPU has to support
+	/// BMI2, and not be an AMD (or Hygon) CPU from before Zen 3, since those execute PEXT in microcode, which is much slower than magics.
+	/// </summary>
+	bool pext_available() {
+#if defined(USE_PEXT)
+		return true;
+#elif defined(HAS_PEXT)
+		unsigned int regs[4] = { 0 };
 
-		for (int r = std::max(0, rnk - 2); r <= std::min(7, rnk + 2); r++) {
+		// Step 1. Get the vendor and the highest supported leaf.
+		cpuid(0, 0, regs);
 
-			for (int f = std::max(0, fl - 2); f <= std::min(7, fl + 2); f++) {
+		unsigned int max_leaf = regs[0];
+		bool amd = regs[1] == 0x68747541 || regs[1] == 0x6f677948; // "Auth"enticAMD or "Hygo"nGenuine
 
-				ring |= (BBS::FileMasks8[f] & BBS::RankMasks8[r]);
-
-			}
+		if (max_leaf < 7) {
+			return false;
 		}
 
-		ring ^= BBS::king_attacks[sq];
-		ring ^= (uint64_t(1) << sq);
+		// Step 2. Check the BMI2 flag, which is bit 8 of EBX in leaf 7.
+		cpuid(7, 0, regs);
 
-		outer_kingring[sq] = ring;
-	}
-
-}
+		if ((regs[1] & (1u << 8)) == 0) {
+			return false;
+		}
 
+		// Step 3. Zen 3 is family 0x19. The family is the base family plus the extended family when the base is 0xF.
+		if (amd) {
+			cpuid(1, 0, regs);
 
+			unsigned int family = (regs[0] >> 8) & 0xF;
+			if (family == 0xF) {
+				family += (regs[0] >> 20) & 0xFF;
+			}
 
-void BBS::INIT() {
-	init_knightAttacks();
-	init_kingAttacks();
+			return family >= 0x19;
+		}
 
-	Zobrist::init_zobrist();
+		return true;
+#else
+		return false;
+#endif
+	}
 
-	EvalBitMasks::initBitMasks();
 
-}
+	/// <summary>
+	/// Change the backend and rebuild the attack tables, since the two backends index them differently.
+	/// </summary>
+	bool set_backend(Backend b) {
+		if (b == PEXT && !pext_available()) {
+			return false;
+		}
 
+#if defined(USE_PEXT)
+		if (b == MAGIC) {
+			return false;
+		}
+#endif
 
+		backend = b;
 
-void Magics::INIT() {
-	_initialize_slider_tables(true);
-	_initialize_slider_tables(false);
-}
+		_initialize_slider_tables(true);
+		_initialize_slider_tables(false);
 
+		return true;
+	}
 
 
-namespace Magics {
+	/// <summary>
+	/// The index of an occupancy in the attack table of a square. With magics, it is the product of the relevant occupancy and the magic
+	/// number, shifted down to the relevant bits. With PEXT, the relevant occupancy bits are simply extracted.
+	/// </summary>
+	inline uint64_t table_index(const SquareTable& table, Bitboard occ) {
+#if defined(USE_PEXT)
+		return _pext_u64(occ, table.mask);
+#else
+#if defined(HAS_PEXT)
+		if (backend == PEXT) {
+			return _pext_u64(occ, table.mask);
+		}
+#endif
+		return ((occ & table.mask) * table.magic) >> table.shift;
+#endif
+	}
 
-	Bitboard _bishopAttacks[64][512] = { {0} };
-	Bitboard _rookAttacks[64][4096] = { {0} };
+	Bitboard _sliderAttacks[ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE] = { 0 };
 
-	Bitboard magic_rook_masks[64] = { 0 };
-	Bitboard magic_bishop_masks[64] = { 0 };
+	SquareTable rook_tables[64];
+	SquareTable bishop_tables[64];
 
 
 	Bitboard set_occupancy(int index, int bit_cnt, Bitboard mask) {
@@ -511,11 +462,12 @@ namespace Magics {
 
 	void _initialize_slider_tables(bool is_rook) {
 
+		// The rook attacks come first in _sliderAttacks, and the bishop attacks after them.
+		Bitboard* attacks = (is_rook) ? _sliderAttacks : _sliderAttacks + ROOK_TABLE_SIZE;
+
 		// Loop through each square.
 		for (int sq = 0; sq < 64; sq++) {
-
-			magic_bishop_masks[sq] = bishopMask(sq);
-			magic_rook_masks[sq] = rookMask(sq);
+			SquareTable& table = (is_rook) ? rook_tables[sq] : bishop_tables[sq];
 
 			Bitboard mask = (is_rook) ? rookMask(sq) : bishopMask(sq);
 
@@ -523,44 +475,40 @@ namespace Magics {
 
 			int occupancy_variations = uint64_t(1) << bit_count;
 
+			assert(bit_count == ((is_rook) ? rook_relevant_bits[sq] : bishop_relevant_bits[sq]));
+
+			// Each square gets exactly as many entries as it has occupancy variations, starting where the previous square's ended.
+			table.mask = mask;
+			table.magic = (is_rook) ? rook_magics[sq] : bishop_magics[sq];
+			table.shift = 64 - bit_count;
+			table.attacks = attacks;
+			attacks += occupancy_variations;
+
 			for (int count = 0; count < occupancy_variations; count++) {
 				Bitboard occupancy = set_occupancy(count, bit_count, mask);
 
-				if (is_rook) {
-					uint64_t magic_index = occupancy * rook_magics[sq] >> (64 - rook_relevant_bits[sq]);
-					_rookAttacks[sq][magic_index] = _getSlowAttack<ROOK>(sq, occupancy);
-				}
-
-				else {
-					uint64_t magic_index = occupancy * bishop_magics[sq] >> (64 - bishop_relevant_bits[sq]);
-					_bishopAttacks[sq][magic_index] = _getSlowAttack<BISHOP>(sq, occupancy);
-				}
+				table.attacks[table_index(table, occupancy)] = (is_rook) ? _getSlowAttack<ROOK>(sq, occupancy) : _getSlowAttack<BISHOP>(sq, occupancy);
 			}
 
 		}
 
+		assert(attacks == ((is_rook) ? _sliderAttacks + ROOK_TABLE_SIZE : _sliderAttacks + ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE));
 	}
 
 
 
 	template <>
 	Bitboard attacks_bb<ROOK>(int sq, Bitboard occ) {
-		//return _rookAttacks[sq][(occ & magic_rook_masks[sq]) * rook_magics[sq] >> 64 - rook_relevant_bits[sq]];
-		occ &= magic_rook_masks[sq];
-		occ *= rook_magics[sq];
-		occ >>= (64 - rook_relevant_bits[sq]);
+		const SquareTable& table = rook_tables[sq];
 
-		return _rookAttacks[sq][occ];
+		return table.attacks[table_index(table, occ)];
 	}
 
 	template <>
 	Bitboard attacks_bb<BISHOP>(int sq, Bitboard occ) {
-		//return _bishopAttacks[sq][(occ & magic_bishop_masks[sq]) * bishop_magics[sq] >> 64 - bishop_relevant_bits[sq]];
-		occ &= magic_bishop_masks[sq];
-		occ *= bishop_magics[sq];
-		occ >>= (64 - bishop_relevant_bits[sq]);
+		const SquareTable& table = bishop_tables[sq];
 
-		return _bishopAttacks[sq][occ];
+		return table.attacks[table_index(table, occ)];
 	}
 
 	template <>
@@ -19,6 +19,7 @@
 #define BITBOARD_H
 
 #include "defs.h"
+#include <algorithm>
 #include <string>
 
 
@@ -29,6 +30,13 @@
 #endif
 #endif
 
+// PEXT indexing of the slider attacks is compiled in if the target supports BMI2. If USE_PEXT is defined, it is always used. Otherwise it is
+//	chosen at startup if the CPU executes PEXT quickly. NO_PEXT leaves it out.
+#if defined(USE_PEXT) || (defined(__BMI2__) && !defined(NO_PEXT))
+#define HAS_PEXT
+#include <immintrin.h> // Used for _pext_u64
+#endif
+
 namespace BBS {
 	const Bitboard EMPTY = std::stoull("0000000000000000000000000000000000000000000000000000000000000000", nullptr, 2);
 	const Bitboard UNIVERSE = std::stoull("1111111111111111111111111111111111111111111111111111111111111111", nullptr, 2);
@@ -101,11 +109,95 @@ namespace BBS {
 	};
 
 
+	/*
+	The attack tables of the leaper pieces and the evaluation masks only depend on the geometry of the board, so they are computed at compile time.
+	*/
+	struct LeaperTables {
+		Bitboard knight[64] = { 0 };
+		Bitboard king[64] = { 0 };
+
+		constexpr LeaperTables() {
+			for (int sq = 0; sq < 64; sq++) {
+				Bitboard sqBrd = uint64_t(1) << sq;
+
+				knight[sq] |= (sqBrd & ~FileMasks8[FILE_H]) << 17;
+				knight[sq] |= (sqBrd & ~FileMasks8[FILE_A]) << 15;
+				knight[sq] |= (sqBrd & ~(FileMasks8[FILE_G] | FileMasks8[FILE_H])) << 10;
+				knight[sq] |= (sqBrd & ~(FileMasks8[FILE_G] | FileMasks8[FILE_H])) >> 6;
+				knight[sq] |= (sqBrd & ~FileMasks8[FILE_H]) >> 15;
+				knight[sq] |= (sqBrd & ~FileMasks8[FILE_A]) >> 17;
+				knight[sq] |= (sqBrd & ~(FileMasks8[FILE_A] | FileMasks8[FILE_B])) << 6;
+				knight[sq] |= (sqBrd & ~(FileMasks8[FILE_A] | FileMasks8[FILE_B])) >> 10;
+
+				king[sq] |= (sqBrd & ~RankMasks8[RANK_8]) << 8;
+				king[sq] |= (sqBrd & ~RankMasks8[RANK_1]) >> 8;
+				king[sq] |= (sqBrd & ~FileMasks8[FILE_H]) << 1;
+				king[sq] |= (sqBrd & ~FileMasks8[FILE_A]) >> 1;
+
+				king[sq] |= (sqBrd & ~(RankMasks8[RANK_8] | FileMasks8[FILE_A])) << 7;
+				king[sq] |= (sqBrd & ~(RankMasks8[RANK_8] | FileMasks8[FILE_H])) << 9;
+				king[sq] |= (sqBrd & ~(RankMasks8[RANK_1] | FileMasks8[FILE_A])) >> 9;
+				king[sq] |= (sqBrd & ~(RankMasks8[RANK_1] | FileMasks8[FILE_H])) >> 7;
+			}
+		}
+	};
+
+	inline constexpr LeaperTables leaper_tables{};
+
 	// knight_attacks[fromSq]
-	extern Bitboard knight_attacks[64];
+	inline constexpr const Bitboard (&knight_attacks)[64] = leaper_tables.knight;
 
 	// king_attacks[fromSq]
-	extern Bitboard king_attacks[64];
+	inline constexpr const Bitboard (&king_attacks)[64] = leaper_tables.king;
+
+
+	/*
+	between_bb[s1][s2] holds the squares strictly between two squares on a common rank, file or diagonal, and line_bb[s1][s2] holds the whole line
+	through them, including the two squares. Both are empty if the squares aren't aligned. They are used for pins and check evasions.
+	*/
+	struct LineTables {
+		Bitboard between[64][64] = { {0} };
+		Bitboard line[64][64] = { {0} };
+
+		constexpr LineTables() {
+			constexpr int directions[8][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1} }; // (file, rank) steps
+
+			for (int s1 = 0; s1 < 64; s1++) {
+				for (int d = 0; d < 8; d++) {
+					// The full line is the ray in this direction and the opposite one, which is the next entry in directions.
+					int opposite = d ^ 1;
+					Bitboard full = uint64_t(1) << s1;
+
+					for (int dir : { d, opposite }) {
+						for (int f = s1 % 8 + directions[dir][0], r = s1 / 8 + directions[dir][1]; f >= 0 && f < 8 && r >= 0 && r < 8;
+							f += directions[dir][0], r += directions[dir][1]) {
+							full |= uint64_t(1) << (8 * r + f);
+						}
+					}
+
+					// Walk the ray and save the squares passed so far as the ones between s1 and each square on it.
+					Bitboard ray = 0;
+
+					for (int f = s1 % 8 + directions[d][0], r = s1 / 8 + directions[d][1]; f >= 0 && f < 8 && r >= 0 && r < 8;
+						f += directions[d][0], r += directions[d][1]) {
+						int s2 = 8 * r + f;
+
+						between[s1][s2] = ray;
+						line[s1][s2] = full;
+						ray |= uint64_t(1) << s2;
+					}
+				}
+			}
+		}
+	};
+
+	inline constexpr LineTables line_tables{};
+
+	// between_bb[sq1][sq2]
+	inline constexpr const Bitboard (&between_bb)[64][64] = line_tables.between;
+
+	// line_bb[sq1][sq2]
+	inline constexpr const Bitboard (&line_bb)[64][64] = line_tables.line;
 
 
 	namespace Zobrist {
@@ -122,27 +214,106 @@ namespace BBS {
 		extern Bitboard castling_keys[16];
 		
 		void init_zobrist();
+
+		// Returns a fingerprint of all the keys above. Used to check that a saved transposition table was made with the same keys.
+		uint64_t version_stamp();
 	}
 
 
 	namespace EvalBitMasks {
-		extern Bitboard passed_pawn_masks[2][64];
-		extern Bitboard isolated_bitmasks[8];
+		struct Tables {
+			Bitboard passed_pawn[2][64] = { {0} };
+			Bitboard isolated[8] = { 0 };
+			Bitboard outpost[2][64] = { {0} };
+			Bitboard rear_span[2][64] = { {0} };
+			Bitboard backwards[2][64] = { {0} };
+			Bitboard outer_kingring[64] = { 0 };
+
+			constexpr Tables() {
+				/*
+				Passed pawn bitmasks
+				*/
+				for (int sq = 0; sq < 64; sq++) {
+					int r = sq / 8;
+					int f = sq % 8;
+
+					Bitboard flankmask = FileMasks8[f] | ((f > FILE_A) ? FileMasks8[f - 1] : 0) | ((f < FILE_H) ? FileMasks8[f + 1] : 0);
+
+					// Create the bitmask for the white pawns
+					for (int i = r + 1; i <= RANK_8; i++) {
+						passed_pawn[WHITE][sq] |= (flankmask & RankMasks8[i]);
+					}
+
+					// Now do it for the black ones.
+					for (int i = r - 1; i >= RANK_1; i--) {
+						passed_pawn[BLACK][sq] |= (flankmask & RankMasks8[i]);
+					}
+				}
+
+				/*
+				Isolated bitmasks
+				*/
+				for (int f = FILE_A; f <= FILE_H; f++) {
+					// If a pawn is isolated, there are no pawns on the files directly next to it.
+					// We shouln't include the file that the pawn is on itself, since we'd not be able to recognize it as isolated if it were doubled.
+					isolated[f] = ((f > FILE_A) ? FileMasks8[f - 1] : 0) | ((f < FILE_H) ? FileMasks8[f + 1] : 0);
+				}
+
+				for (int sq = 0; sq < 64; sq++) {
+					// Outpost masks -> these can just be made by AND'ing the isolated bitmasks and passed pawn bitmasks.
+					outpost[WHITE][sq] = (passed_pawn[WHITE][sq] & isolated[sq % 8]);
+					outpost[BLACK][sq] = (passed_pawn[BLACK][sq] & isolated[sq % 8]);
+
+					// Rearspan bitmasks. The squares behind pawns.
+					rear_span[WHITE][sq] = (passed_pawn[BLACK][sq] & FileMasks8[sq % 8]);
+					rear_span[BLACK][sq] = (passed_pawn[WHITE][sq] & FileMasks8[sq % 8]);
+
+					// Backwards bitmasks. These are the squares on the current rank and all others behind it, on the adjacent files if a square.
+					backwards[WHITE][sq] = (passed_pawn[BLACK][sq] & ~FileMasks8[sq % 8]);
+					backwards[BLACK][sq] = (passed_pawn[WHITE][sq] & ~FileMasks8[sq % 8]);
+
+					if (sq % 8 != FILE_H) {
+						backwards[WHITE][sq] |= (uint64_t(1) << (sq + 1));
+						backwards[BLACK][sq] |= (uint64_t(1) << (sq + 1));
+					}
+					if (sq % 8 != FILE_A) {
+						backwards[WHITE][sq] |= (uint64_t(1) << (sq - 1));
+						backwards[BLACK][sq] |= (uint64_t(1) << (sq - 1));
+					}
+
+					// Outer king-rings. These are just the 16 squares on the outside of the ring, that the king would be able to move to on an empty board.
+					Bitboard ring = 0;
+					int rnk = sq / 8;
+					int fl = sq % 8;
+
+					for (int r = std::max(0, rnk - 2); r <= std::min(7, rnk + 2); r++) {
+						for (int f = std::max(0, fl - 2); f <= std::min(7, fl + 2); f++) {
+							ring |= (FileMasks8[f] & RankMasks8[r]);
+						}
+					}
+
+					ring ^= leaper_tables.king[sq];
+					ring ^= (uint64_t(1) << sq);
+
+					outer_kingring[sq] = ring;
+				}
+			}
+		};
 
-		extern Bitboard outpost_masks[2][64];
+		inline constexpr Tables tables{};
 
-		extern Bitboard rear_span_masks[2][64];
+		inline constexpr const Bitboard (&passed_pawn_masks)[2][64] = tables.passed_pawn;
+		inline constexpr const Bitboard (&isolated_bitmasks)[8] = tables.isolated;
 
-		extern Bitboard backwards_masks[2][64];
+		inline constexpr const Bitboard (&outpost_masks)[2][64] = tables.outpost;
 
-		extern Bitboard outer_kingring[64];
+		inline constexpr const Bitboard (&rear_span_masks)[2][64] = tables.rear_span;
 
-		void initBitMasks();
-	}
+		inline constexpr const Bitboard (&backwards_masks)[2][64] = tables.backwards;
 
+		inline constexpr const Bitboard (&outer_kingring)[64] = tables.outer_kingring;
+	}
 
-	void init_knightAttacks();
-	void init_kingAttacks();
 
 	void INIT();
 }
@@ -157,21 +328,48 @@ namespace Magics {
 	extern const int rook_relevant_bits[64];
 	extern const int bishop_relevant_bits[64];
 
-	// All attack masks of rooks and bishops excluding edges.
-	extern Bitboard magic_rook_masks[64];
-	extern Bitboard magic_bishop_masks[64];
+	// Everything needed to look up the attacks of a slider on one square. It is kept together such that a lookup only touches one cache line
+	//	besides the attacks themselves.
+	struct alignas(32) SquareTable {
+		Bitboard mask = 0;				// The attack mask excluding edges, which are the squares whose occupancy matters.
+		Bitboard magic = 0;
+		Bitboard* attacks = nullptr;	// This square's part of _sliderAttacks.
+		int shift = 0;					// 64 minus the number of relevant occupancy bits.
+	};
 
+	extern SquareTable rook_tables[64];
+	extern SquareTable bishop_tables[64];
 
-	// These are the tables holding all attacks to different occupancies on each square.
-	extern Bitboard _bishopAttacks[64][512];
-	extern Bitboard _rookAttacks[64][4096];
 
-	// These functios are only used to initialize _bishopAttacks and _rookAttacks
+	// The attacks of all squares are stored after each other, with exactly one entry per occupancy of the relevant bits. This is 102400
+	//	entries for the rooks and 5248 for the bishops, which is 841 KB, instead of the 2.3 MB of tables with room for the worst square.
+	constexpr int ROOK_TABLE_SIZE = 102400;
+	constexpr int BISHOP_TABLE_SIZE = 5248;
+
+	extern Bitboard _sliderAttacks[ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE];
+
+	// These functios are only used to initialize the attack tables
 	template<piece PCE> Bitboard _getSlowAttack(int sq, Bitboard occupied);
 	void _initialize_slider_tables(bool is_rook);
 	Bitboard set_occupancy(int index, int bit_cnt, Bitboard mask);
 
-	// To initialize the bishopMagics, rookMagics and all attack tables.
+
+	// The ways the attack tables can be indexed. Magic multiplication works everywhere, while PEXT needs BMI2 and is only fast on Intel
+	//	since Haswell and AMD since Zen 3.
+	enum Backend : int { MAGIC = 0, PEXT = 1 };
+
+	extern Backend backend;
+
+	// Returns true if PEXT is compiled in and the CPU executes it quickly.
+	bool pext_available();
+
+	// Change the indexing of the attack tables and rebuild them. This can't be done while searching. Returns false if the backend isn't available.
+	bool set_backend(Backend b);
+
+	inline std::string backend_name(Backend b) { return (b == PEXT) ? "PEXT" : "Magic"; }
+
+
+	// To initialize the bishopMagics, rookMagics and all attack tables. The backend is chosen here.
 	void INIT();
 
 
@@ -19,6 +19,7 @@
 #define DEFS_H
 
 #include <iostream>
+#include <cstdint>
 #include <assert.h>
 
 
@@ -27,6 +28,47 @@
 #endif
 
 
+// Ask the CPU to start loading the cache line at addr.
+inline void prefetch(const void* addr) {
+#if (defined(_MSC_VER) || defined(__INTEL_COMPILER))
+	_mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0);
+#else
+	__builtin_prefetch(addr);
+#endif
+}
+
+
+/// <summary>
+/// Score holds a middlegame and an endgame value packed into a single integer, with the middlegame value in the upper 16 bits and the endgame
+/// value in the lower 16 bits, such that both of them are updated by a single addition. Both values have to stay within the range of an int16_t.
+/// </summary>
+class Score {
+public:
+	constexpr Score() : packed(0) {}
+	constexpr Score(int m, int e) : packed(int(unsigned(m) << 16) + e) {}
+
+	// A negative endgame value borrows one from the middlegame half, which is undone by rounding before the shift.
+	constexpr int mg() const { return int16_t(uint16_t(unsigned(packed + 0x8000) >> 16)); }
+	constexpr int eg() const { return int16_t(uint16_t(unsigned(packed))); }
+
+	// Some operators.
+	constexpr Score& operator+=(const Score& rhs) { packed += rhs.packed; return *this; }
+	constexpr Score& operator-=(const Score& rhs) { packed -= rhs.packed; return *this; }
+	constexpr Score operator+(const Score& rhs) const { return from_packed(packed + rhs.packed); }
+	constexpr Score operator-(const Score& rhs) const { return from_packed(packed - rhs.packed); }
+	constexpr Score operator-() const { return from_packed(-packed); }
+	constexpr Score operator*(int i) const { return from_packed(int(unsigned(packed) * unsigned(i))); }
+
+	constexpr bool operator==(const Score& rhs) const { return packed == rhs.packed; }
+	constexpr bool operator!=(const Score& rhs) const { return packed != rhs.packed; }
+
+private:
+	static constexpr Score from_packed(int p) { Score s; s.packed = p; return s; }
+
+	int packed;
+};
+
+
 constexpr int MAXPOSITIONMOVES = 256;
 constexpr int MAXGAMEMOVES = 1024;
 constexpr int NOMOVE = 0;
@@ -68,17 +110,34 @@ constexpr int VALUE_NONE = 50000;
 
 
 // Used to allocate size x in megabytes of caches.
-#define KB(x) (x << 10)
-#define MB(x) (x << 20)
+// The arithmetic is done in 64 bits, such that sizes above 2GB don't overflow.
+#define KB(x) (uint64_t(x) << 10)
+#define MB(x) (uint64_t(x) << 20)
 
 // Boundaries and default size of transposition table
-#define TT_MAX_SIZE 1000
+#if defined(IS_64BIT)
+#define TT_MAX_SIZE 131072
+#else
+#define TT_MAX_SIZE 1024
+#endif
 #define TT_DEFAULT_SIZE 16
 #define TT_MIN_SIZE 1
 
+// Boundaries and default size of the quiescence search's table. A size of 0 disables it.
+#define QTT_MAX_SIZE 64
+#define QTT_DEFAULT_SIZE 1
+#define QTT_MIN_SIZE 0
+
+// Boundaries and default size of the evaluation hash table. It is the size per thread, or the total size if the table is shared.
+//	Per-thread tables are capped at EVAL_TABLE_MAX_THREAD_SIZE, such that many threads can't multiply the option into gigabytes.
+#define EVAL_TABLE_MAX_SIZE 1024
+#define EVAL_TABLE_MAX_THREAD_SIZE 64
+#define EVAL_TABLE_DEFAULT_SIZE 1
+#define EVAL_TABLE_MIN_SIZE 1
+
 
 // Amount of threads to use
-#define THREADS_MAX_NUM 8
+#define THREADS_MAX_NUM 256
 #define THREADS_DEFAULT_NUM 1
 #define THREADS_MIN_NUM 1
 
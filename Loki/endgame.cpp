@@ -0,0 +1,612 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "endgame.h"
+#include "evaluation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace Endgame {
+
+	namespace {
+
+		/// <summary>
+		/// The registered functions. The evaluation functions are keyed by the material key alone, while the scaling functions are keyed by the
+		/// material key and the side they scale, since a configuration can have a scaling function for both sides.
+		/// </summary>
+		struct EvalEntry {
+			EndgameEval func;
+			SIDE strong;
+		};
+
+		std::map<uint64_t, EvalEntry> eval_functions;
+		std::map<std::pair<uint64_t, int>, EndgameScale> scale_functions;
+
+
+		inline int file_of(int sq) { return sq % 8; }
+		inline int rank_of(int sq) { return sq / 8; }
+
+		inline int distance(int s1, int s2) {
+			return std::max(std::abs(file_of(s1) - file_of(s2)), std::abs(rank_of(s1) - rank_of(s2)));
+		}
+
+		inline bool opposite_colors(int s1, int s2) {
+			return ((file_of(s1) + rank_of(s1) + file_of(s2) + rank_of(s2)) & 1) != 0;
+		}
+
+		inline SIDE opponent(SIDE s) { return (s == WHITE) ? BLACK : WHITE; }
+
+		// Flip a square vertically if it belongs to black, such that all endgames can be written from white's perspective.
+		inline int relative_square(SIDE s, int sq) { return (s == WHITE) ? sq : sq ^ 56; }
+
+
+		/*
+		Bonuses for driving the losing king towards the edge or a corner, and for keeping the kings close together.
+		*/
+		inline int push_to_edge(int sq) {
+			int fd = std::min(file_of(sq), FILE_H - file_of(sq));
+			int rd = std::min(rank_of(sq), RANK_8 - rank_of(sq));
+
+			return 90 - (7 * fd * fd / 2 + 7 * rd * rd / 2);
+		}
+
+		// Largest in the a1 and h8 corners.
+		inline int push_to_corner(int sq) { return std::abs(7 - rank_of(sq) - file_of(sq)); }
+
+		inline int push_close(int s1, int s2) { return 140 - 20 * distance(s1, s2); }
+		inline int push_away(int s1, int s2) { return 120 - push_close(s1, s2); }
+
+
+		/// <summary>
+		/// Compute the material key of an endgame from a code like "KBNK", where the strong side's pieces come first.
+		/// </summary>
+		uint64_t material_key(const std::string& code, SIDE strong) {
+			const std::string pieces = "PNBRQ";
+			size_t split = code.find('K', 1);
+
+			std::string sides[2];
+			sides[strong] = code.substr(0, split);
+			sides[opponent(strong)] = code.substr(split);
+
+			// Same scheme as GameState_t::materialKey.
+			uint64_t key = 0;
+
+			for (int side = BLACK; side <= WHITE; side++) {
+				for (int pce = PAWN; pce <= QUEEN; pce++) {
+					int count = int(std::count(sides[side].begin(), sides[side].end(), pieces[pce]));
+
+					for (int cnt = 0; cnt < count; cnt++) {
+						key ^= BBS::Zobrist::piece_keys[side][pce][cnt];
+					}
+				}
+			}
+
+			return key;
+		}
+
+		void add_eval(const std::string& code, EndgameEval func) {
+			for (SIDE strong : { WHITE, BLACK }) {
+				eval_functions[material_key(code, strong)] = { func, strong };
+			}
+		}
+
+		void add_scale(const std::string& code, EndgameScale func) {
+			for (SIDE strong : { WHITE, BLACK }) {
+				scale_functions[{ material_key(code, strong), strong }] = func;
+			}
+		}
+
+
+
+		/* --------------------------------------------------------------- */
+		/* --------------- Endgames with a known material ---------------- */
+		/* --------------------------------------------------------------- */
+
+		/// <summary>
+		/// KPK is evaluated perfectly with the bitbase.
+		/// </summary>
+		int KPK(const GameState_t* pos, SIDE strong) {
+			SIDE weak = opponent(strong);
+			int psq = bitScanForward(pos->pieceBBS[PAWN][strong]);
+
+			if (!Bitbase::probe_kpk(strong, pos->king_squares[strong], psq, pos->king_squares[weak], pos->side_to_move)) {
+				return 0;
+			}
+
+			return KNOWN_WIN + pawn_value.eg() + rank_of(relative_square(strong, psq));
+		}
+
+
+		/// <summary>
+		/// KBNK is a win, but it can only be forced in the corners with the same color as the bishop.
+		/// </summary>
+		int KBNK(const GameState_t* pos, SIDE strong) {
+			SIDE weak = opponent(strong);
+			int strong_ksq = pos->king_squares[strong];
+			int weak_ksq = pos->king_squares[weak];
+			int bsq = bitScanForward(pos->pieceBBS[BISHOP][strong]);
+
+			// push_to_corner drives the king towards a1 and h8, which are dark squares. With a light-squared bishop the board is mirrored.
+			int corner_sq = opposite_colors(bsq, A1) ? weak_ksq ^ 7 : weak_ksq;
+
+			return KNOWN_WIN + push_close(strong_ksq, weak_ksq) + 420 * push_to_corner(corner_sq);
+		}
+
+
+		/// <summary>
+		/// KRKP is a win if the strong king is in front of the pawn or the weak king is too far away. Otherwise it is most often a draw.
+		/// </summary>
+		int KRKP(const GameState_t* pos, SIDE strong) {
+			SIDE weak = opponent(strong);
+			int strong_ksq = relative_square(strong, pos->king_squares[strong]);
+			int weak_ksq = relative_square(strong, pos->king_squares[weak]);
+			int rsq = relative_square(strong, bitScanForward(pos->pieceBBS[ROOK][strong]));
+			int psq = relative_square(strong, bitScanForward(pos->pieceBBS[PAWN][weak]));
+			int queening_sq = file_of(psq);
+
+			// Step 1. The strong king is in front of the pawn.
+			if (file_of(strong_ksq) == file_of(psq) && rank_of(strong_ksq) < rank_of(psq)) {
+				return rook_value.eg() - distance(strong_ksq, psq);
+			}
+
+			// Step 2. The weak king is too far away from both the pawn and the rook.
+			if (distance(weak_ksq, psq) >= 3 + (pos->side_to_move == weak) && distance(weak_ksq, rsq) >= 3) {
+				return rook_value.eg() - distance(strong_ksq, psq);
+			}
+
+			// Step 3. The pawn is far advanced and supported by its king, while the strong king is far away.
+			if (rank_of(weak_ksq) <= RANK_3 && distance(weak_ksq, psq) == 1 && rank_of(strong_ksq) >= RANK_4
+				&& distance(strong_ksq, psq) > 2 + (pos->side_to_move == strong)) {
+				return 80 - 8 * distance(strong_ksq, psq);
+			}
+
+			// Step 4. Otherwise it is a race between the kings.
+			return 200 - 8 * (distance(strong_ksq, psq - 8) - distance(weak_ksq, psq - 8) - distance(psq, queening_sq));
+		}
+
+
+		/// <summary>
+		/// KRKB is a draw, but the weak side has to keep its king away from the edge.
+		/// </summary>
+		int KRKB(const GameState_t* pos, SIDE strong) {
+			return push_to_edge(pos->king_squares[opponent(strong)]);
+		}
+
+
+		/// <summary>
+		/// KRKN is a draw as well, but the weak side can lose if the king and knight get separated.
+		/// </summary>
+		int KRKN(const GameState_t* pos, SIDE strong) {
+			SIDE weak = opponent(strong);
+			int weak_ksq = pos->king_squares[weak];
+			int nsq = bitScanForward(pos->pieceBBS[KNIGHT][weak]);
+
+			return push_to_edge(weak_ksq) + push_away(weak_ksq, nsq);
+		}
+
+
+		/// <summary>
+		/// KQKP is a win, except for a bishop- or rook pawn on the seventh rank that is supported by its king.
+		/// </summary>
+		int KQKP(const GameState_t* pos, SIDE strong) {
+			SIDE weak = opponent(strong);
+			int strong_ksq = pos->king_squares[strong];
+			int weak_ksq = pos->king_squares[weak];
+			int psq = bitScanForward(pos->pieceBBS[PAWN][weak]);
+			int pawn_file = file_of(psq);
+
+			int result = push_close(strong_ksq, weak_ksq);
+
+			if (rank_of(relative_square(weak, psq)) != RANK_7 || distance(weak_ksq, psq) != 1
+				|| (pawn_file != FILE_A && pawn_file != FILE_C && pawn_file != FILE_F && pawn_file != FILE_H)) {
+				result += queen_value.eg() - pawn_value.eg();
+			}
+
+			return result;
+		}
+
+
+		/// <summary>
+		/// KQKR is a win, which is forced by driving the weak king to the edge.
+		/// </summary>
+		int KQKR(const GameState_t* pos, SIDE strong) {
+			SIDE weak = opponent(strong);
+			int strong_ksq = pos->king_squares[strong];
+			int weak_ksq = pos->king_squares[weak];
+
+			return queen_value.eg() - rook_value.eg() + push_to_edge(weak_ksq) + push_close(strong_ksq, weak_ksq);
+		}
+
+
+		/// <summary>
+		/// Two knights can't force mate.
+		/// </summary>
+		int KNNK(const GameState_t*, SIDE) {
+			return 0;
+		}
+
+
+		/// <summary>
+		/// KRPKR draws that the generic evaluation doesn't see, like the third-rank (Philidor) defence and the defending king blocking the pawn.
+		/// </summary>
+		int KRPKR(const GameState_t* pos, SIDE strong) {
+			SIDE weak = opponent(strong);
+
+			// Step 1. Normalize the position such that the pawn is white and on the queen side.
+			int psq = relative_square(strong, bitScanForward(pos->pieceBBS[PAWN][strong]));
+			int mirror = (file_of(psq) >= FILE_E) ? 7 : 0;
+
+			psq ^= mirror;
+			int strong_ksq = relative_square(strong, pos->king_squares[strong]) ^ mirror;
+			int weak_ksq = relative_square(strong, pos->king_squares[weak]) ^ mirror;
+			int strong_rsq = relative_square(strong, bitScanForward(pos->pieceBBS[ROOK][strong])) ^ mirror;
+			int weak_rsq = relative_square(strong, bitScanForward(pos->pieceBBS[ROOK][weak])) ^ mirror;
+
+			int r = rank_of(psq);
+			int queening_sq = psq % 8 + 56;
+			int tempo = (pos->side_to_move == strong) ? 1 : 0;
+
+			// Step 2. The third-rank defence: The pawn isn't too far advanced, the weak king holds the queening square and the weak rook cuts
+			//	off the strong king.
+			if (r <= RANK_5 && distance(weak_ksq, queening_sq) <= 1 && strong_ksq <= H5
+				&& (rank_of(weak_rsq) == RANK_6 || (r <= RANK_3 && rank_of(strong_rsq) != RANK_6))) {
+				return SCALE_DRAW;
+			}
+
+			// Step 3. When the pawn has reached the sixth rank, the weak rook can check from behind.
+			if (r == RANK_6 && distance(weak_ksq, queening_sq) <= 1 && rank_of(strong_ksq) + tempo <= RANK_6
+				&& (rank_of(weak_rsq) == RANK_1 || (!tempo && std::abs(file_of(weak_rsq) - file_of(psq)) >= 3))) {
+				return SCALE_DRAW;
+			}
+
+			if (r >= RANK_6 && weak_ksq == queening_sq && rank_of(weak_rsq) == RANK_1 && (!tempo || distance(strong_ksq, psq) >= 2)) {
+				return SCALE_DRAW;
+			}
+
+			// Step 4. A pawn on a7 with the rook in front of it is a draw if the weak king is on g7 or h7 and the weak rook is behind the pawn.
+			if (psq == A7 && strong_rsq == A8 && (weak_ksq == H7 || weak_ksq == G7) && file_of(weak_rsq) == FILE_A
+				&& (rank_of(weak_rsq) <= RANK_3 || file_of(strong_ksq) >= FILE_D || rank_of(strong_ksq) <= RANK_5)) {
+				return SCALE_DRAW;
+			}
+
+			// Step 5. The weak king blocks the pawn, and the strong king is too far away to chase it.
+			if (r <= RANK_5 && weak_ksq == psq + 8 && distance(strong_ksq, psq) - tempo >= 2 && distance(strong_ksq, weak_rsq) - tempo >= 2) {
+				return SCALE_DRAW;
+			}
+
+			return SCALE_NONE;
+		}
+	}
+
+
+
+	/* --------------------------------------------------------------- */
+	/* ---------------------- Generic endgames ----------------------- */
+	/* --------------------------------------------------------------- */
+
+	/// <summary>
+	/// KXK: Mating material against a lone king. The weak king is driven to the edge while the strong king comes closer.
+	/// </summary>
+	int KXK(const GameState_t* pos, SIDE strong) {
+		SIDE weak = opponent(strong);
+		int strong_ksq = pos->king_squares[strong];
+		int weak_ksq = pos->king_squares[weak];
+
+		// Step 1. Stalemate detection. The lone king has no other moves than its own, so if all of them are attacked it is stalemate.
+		if (pos->side_to_move == weak && !pos->in_check()) {
+			Bitboard king_moves = BBS::king_attacks[weak_ksq];
+			bool has_move = false;
+
+			while (king_moves) {
+				if (!pos->square_attacked(PopBit(&king_moves), strong)) {
+					has_move = true;
+					break;
+				}
+			}
+
+			if (!has_move) {
+				return 0;
+			}
+		}
+
+		// Step 2. The material and the mating bonuses.
+		int result = ((strong == WHITE) ? non_pawn_material<EG, WHITE>(pos) : non_pawn_material<EG, BLACK>(pos))
+			+ countBits(pos->pieceBBS[PAWN][strong]) * pawn_value.eg()
+			+ push_to_edge(weak_ksq) + push_close(strong_ksq, weak_ksq);
+
+		// Step 3. With a queen, a rook, bishop and knight, or bishops of both colors, the mate can be forced.
+		Bitboard bishops = pos->pieceBBS[BISHOP][strong];
+
+		if (pos->pieceBBS[QUEEN][strong] || pos->pieceBBS[ROOK][strong]
+			|| (bishops && pos->pieceBBS[KNIGHT][strong])
+			|| ((bishops & BBS::DARK_SQUARES) && (bishops & BBS::LIGHT_SQUARES))) {
+			result += KNOWN_WIN;
+		}
+
+		return result;
+	}
+
+
+	/// <summary>
+	/// KBPsK: A bishop and pawns that are all on the a- or h-file. If the queening square isn't of the bishop's color, and the weak king
+	/// controls it, it's a draw.
+	/// </summary>
+	int KBPsK(const GameState_t* pos, SIDE strong) {
+		SIDE weak = opponent(strong);
+		Bitboard pawns = pos->pieceBBS[PAWN][strong];
+
+		if ((pawns & ~BBS::FileMasks8[FILE_A]) == 0 || (pawns & ~BBS::FileMasks8[FILE_H]) == 0) {
+			int bsq = bitScanForward(pos->pieceBBS[BISHOP][strong]);
+			int queening_sq = relative_square(strong, file_of(bitScanForward(pawns)) + 56);
+
+			if (opposite_colors(queening_sq, bsq) && distance(queening_sq, pos->king_squares[weak]) <= 1) {
+				return SCALE_DRAW;
+			}
+		}
+
+		return SCALE_NONE;
+	}
+
+
+	/// <summary>
+	/// KPsK: Pawns on a single rook file are drawn if the weak king is in front of them.
+	/// </summary>
+	int KPsK(const GameState_t* pos, SIDE strong) {
+		SIDE weak = opponent(strong);
+		Bitboard pawns = pos->pieceBBS[PAWN][strong];
+
+		if (((pawns & ~BBS::FileMasks8[FILE_A]) == 0 || (pawns & ~BBS::FileMasks8[FILE_H]) == 0)
+			&& (pawns & ~BBS::EvalBitMasks::passed_pawn_masks[weak][pos->king_squares[weak]]) == 0) {
+			return SCALE_DRAW;
+		}
+
+		return SCALE_NONE;
+	}
+
+
+	/// <summary>
+	/// Opposite colored bishops with pawns: Even a couple of extra pawns are often not enough to win.
+	/// </summary>
+	int KBKB_pawns(const GameState_t* pos, SIDE strong) {
+		SIDE weak = opponent(strong);
+
+		if (!opposite_colors(bitScanForward(pos->pieceBBS[BISHOP][strong]), bitScanForward(pos->pieceBBS[BISHOP][weak]))) {
+			return SCALE_NONE;
+		}
+
+		return (countBits(pos->pieceBBS[PAWN][strong]) > 1) ? 31 : 9;
+	}
+
+
+
+	EndgameEval probe_eval(uint64_t material_key, SIDE& strong) {
+		auto it = eval_functions.find(material_key);
+
+		if (it == eval_functions.end()) {
+			return nullptr;
+		}
+
+		strong = it->second.strong;
+		return it->second.func;
+	}
+
+
+	EndgameScale probe_scale(uint64_t material_key, SIDE strong) {
+		auto it = scale_functions.find({ material_key, strong });
+
+		return (it == scale_functions.end()) ? nullptr : it->second;
+	}
+
+
+
+	namespace Bitbase {
+
+		namespace {
+
+			// The pawn is normalized to be white and on the files a-d. It can then be on 24 squares, and together with the king squares and the
+			//	side to move, this gives the number of positions.
+			constexpr int MAX_INDEX = 2 * 24 * 64 * 64;
+
+			// One bit for each position. It is set if the position is won.
+			uint32_t bitbase[MAX_INDEX / 32] = { 0 };
+
+			// Set when the bitbase has been computed.
+			std::atomic<bool> ready{ false };
+
+			enum Result : uint8_t { INVALID = 0, UNKNOWN = 1, DRAW = 2, WIN = 4 };
+
+
+			// Bits 0-5: White king, 6-11: Black king, 12: Side to move, 13-14: Pawn file, 15-17: RANK_7 - pawn rank.
+			inline int index(SIDE stm, int bksq, int wksq, int psq) {
+				return wksq | (bksq << 6) | (int(stm) << 12) | (file_of(psq) << 13) | ((RANK_7 - rank_of(psq)) << 15);
+			}
+
+			inline Bitboard pawn_attacks(int psq) {
+				Bitboard b = uint64_t(1) << psq;
+				return shift<NORTHWEST>(b) | shift<NORTHEAST>(b);
+			}
+
+
+			/// <summary>
+			/// Classify a position without looking at its successors. Illegal positions are INVALID, and the trivial wins and draws are found.
+			/// </summary>
+			Result initial_result(SIDE stm, int wksq, int bksq, int psq) {
+				// Step 1. The kings are next to each other, a king is on the pawn, or the black king can be captured.
+				if (distance(wksq, bksq) <= 1 || wksq == psq || bksq == psq
+					|| (stm == WHITE && (pawn_attacks(psq) & (uint64_t(1) << bksq)))) {
+					return INVALID;
+				}
+
+				// Step 2. The pawn promotes without being captured.
+				if (stm == WHITE && rank_of(psq) == RANK_7 && wksq != psq + 8
+					&& (distance(bksq, psq + 8) > 1 || distance(wksq, psq + 8) == 1)) {
+					return WIN;
+				}
+
+				// Step 3. Black is stalemated, or the pawn can be captured.
+				if (stm == BLACK
+					&& ((BBS::king_attacks[bksq] & ~(BBS::king_attacks[wksq] | pawn_attacks(psq))) == 0
+						|| (BBS::king_attacks[bksq] & ~BBS::king_attacks[wksq] & (uint64_t(1) << psq)))) {
+					return DRAW;
+				}
+
+				return UNKNOWN;
+			}
+
+
+			/// <summary>
+			/// Classify a position from its successors. If white can reach a win it is won, and if black can reach a draw it is drawn. If all
+			/// successors are known and none of those is, it is the other.
+			/// </summary>
+			Result classify(const std::vector<uint8_t>& db, SIDE stm, int wksq, int bksq, int psq) {
+				const Result good = (stm == WHITE) ? WIN : DRAW;
+				const Result bad = (stm == WHITE) ? DRAW : WIN;
+
+				int r = INVALID;
+				Bitboard king_moves = BBS::king_attacks[(stm == WHITE) ? wksq : bksq];
+
+				while (king_moves) {
+					int to = PopBit(&king_moves);
+					r |= (stm == WHITE) ? db[index(BLACK, bksq, to, psq)] : db[index(WHITE, to, wksq, psq)];
+				}
+
+				if (stm == WHITE) {
+					// A pawn push to the eighth rank is handled in initial_result.
+					if (rank_of(psq) < RANK_7) {
+						r |= db[index(BLACK, bksq, wksq, psq + 8)];
+					}
+
+					if (rank_of(psq) == RANK_2 && psq + 8 != wksq && psq + 8 != bksq) {
+						r |= db[index(BLACK, bksq, wksq, psq + 16)];
+					}
+				}
+
+				return (r & good) ? good : ((r & UNKNOWN) ? UNKNOWN : bad);
+			}
+		}
+
+
+		/// <summary>
+		/// Compute the bitbase by retrograde analysis: All positions are classified until nothing changes anymore.
+		/// </summary>
+		void init() {
+			std::vector<uint8_t> db(MAX_INDEX, INVALID);
+
+			// Step 1. Decode all indices and classify the positions we know the result of.
+			auto decode = [](int idx, SIDE& stm, int& wksq, int& bksq, int& psq) {
+				wksq = idx & 63;
+				bksq = (idx >> 6) & 63;
+				stm = SIDE((idx >> 12) & 1);
+				psq = 8 * (RANK_7 - ((idx >> 15) & 7)) + ((idx >> 13) & 3);
+			};
+
+			std::vector<int> unknown;
+
+			for (int idx = 0; idx < MAX_INDEX; idx++) {
+				SIDE stm; int wksq, bksq, psq;
+				decode(idx, stm, wksq, bksq, psq);
+
+				db[idx] = initial_result(stm, wksq, bksq, psq);
+
+				if (db[idx] == UNKNOWN) {
+					unknown.push_back(idx);
+				}
+			}
+
+			// Step 2. Iterate over the unknown positions until none of them can be classified. The ones that are resolved are removed from the
+			//	list, such that each pass only looks at the positions that are still unknown.
+			size_t last_size = 0;
+
+			while (unknown.size() != last_size) {
+				last_size = unknown.size();
+				size_t remaining = 0;
+
+				for (int idx : unknown) {
+					SIDE stm; int wksq, bksq, psq;
+					decode(idx, stm, wksq, bksq, psq);
+
+					Result r = classify(db, stm, wksq, bksq, psq);
+
+					if (r != UNKNOWN) {
+						db[idx] = r;
+					}
+					else {
+						unknown[remaining++] = idx;
+					}
+				}
+
+				unknown.resize(remaining);
+			}
+
+			// Step 3. Save the wins in the bitbase. The positions that are still unknown are draws.
+			for (int idx = 0; idx < MAX_INDEX; idx++) {
+				if (db[idx] == WIN) {
+					bitbase[idx / 32] |= uint32_t(1) << (idx & 31);
+				}
+			}
+
+			ready.store(true, std::memory_order_release);
+		}
+
+
+		bool probe_kpk(SIDE strong, int strong_ksq, int psq, int weak_ksq, SIDE stm) {
+			// The bitbase is computed in the background at startup. In the rare case that a KPK position is evaluated before that is done, we
+			//	wait for it.
+			while (!ready.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+
+			// Make the pawn white and put it on the files a-d.
+			int flip = (strong == WHITE) ? 0 : 56;
+			int mirror = (file_of(psq) >= FILE_E) ? 7 : 0;
+
+			int wksq = strong_ksq ^ flip ^ mirror;
+			int bksq = weak_ksq ^ flip ^ mirror;
+			psq = psq ^ flip ^ mirror;
+
+			int idx = index((stm == strong) ? WHITE : BLACK, bksq, wksq, psq);
+
+			return (bitbase[idx / 32] >> (idx & 31)) & 1;
+		}
+	}
+
+
+
+	void INIT() {
+		// The bitbase takes a while to compute, and it is very rarely needed right away, so it is done on a background thread. The future
+		//	waits for it to finish if the program exits before then.
+		static std::future<void> bitbase_init = std::async(std::launch::async, Bitbase::init);
+
+		add_eval("KPK", KPK);
+		add_eval("KBNK", KBNK);
+		add_eval("KRKP", KRKP);
+		add_eval("KRKB", KRKB);
+		add_eval("KRKN", KRKN);
+		add_eval("KQKP", KQKP);
+		add_eval("KQKR", KQKR);
+		add_eval("KNNK", KNNK);
+
+		add_scale("KRPKR", KRPKR);
+	}
+}
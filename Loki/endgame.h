@@ -0,0 +1,74 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ENDGAME_H
+#define ENDGAME_H
+#include "position.h"
+#include "materialtable.h"
+
+
+/*
+Specialised endgame knowledge. Endgames that the generic evaluation handles badly are recognized by their material key, and are then
+evaluated or scaled by a function written for that particular endgame.
+*/
+namespace Endgame {
+
+	// The score given to positions that are known to be won. It is far below the mate scores, but above any normal evaluation.
+	constexpr int KNOWN_WIN = 10000;
+
+
+	/// <summary>
+	/// Look up the specialised evaluation function for a material configuration.
+	/// </summary>
+	/// <param name="material_key">The material key of the position.</param>
+	/// <param name="strong">Set to the side the function should be called for.</param>
+	/// <returns>The evaluation function, or nullptr if there is none.</returns>
+	EndgameEval probe_eval(uint64_t material_key, SIDE& strong);
+
+	/// <summary>
+	/// Look up the specialised scaling function for one side of a material configuration.
+	/// </summary>
+	EndgameScale probe_scale(uint64_t material_key, SIDE strong);
+
+
+	/*
+	Endgames that aren't recognized by a single material key, since any number of pieces or pawns fits them.
+	*/
+	int KXK(const GameState_t* pos, SIDE strong);		// Mating material against a lone king.
+	int KBPsK(const GameState_t* pos, SIDE strong);		// Bishop and rook pawns with the wrong bishop.
+	int KPsK(const GameState_t* pos, SIDE strong);		// Rook pawns against a king in front of them.
+	int KBKB_pawns(const GameState_t* pos, SIDE strong);	// Opposite colored bishops with pawns.
+
+
+	/// <summary>
+	/// Bitbases holding the result of all positions of an endgame. KPK is computed at startup by retrograde analysis. Probing waits for the
+	/// computation to finish.
+	/// </summary>
+	namespace Bitbase {
+		void init();
+
+		// Returns true if the KPK position is won for the side with the pawn.
+		bool probe_kpk(SIDE strong, int strong_ksq, int psq, int weak_ksq, SIDE stm);
+	}
+
+
+	// Register all the endgame functions and start building the KPK bitbase in the background.
+	void INIT();
+}
+
+
+#endif
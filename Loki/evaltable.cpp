@@ -16,14 +16,26 @@
 	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "evaltable.h"
+#include "defs.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
 
 
 
 /// <summary>
-/// Default constructor for the evaluation table. It allocates memory for the entries.
+/// Constructor for the evaluation table. It allocates the largest power of two number of entries that fits in the given size.
 /// </summary>
-EvaluationTable::EvaluationTable() {
-	num_slots = EVAL_TABLE_SIZE / sizeof(EvalEntry_t);
+/// <param name="mb_size">The size of the table in MB.</param>
+EvaluationTable::EvaluationTable(size_t mb_size) {
+	mb = std::max(size_t(1), mb_size);
+
+	num_slots = 1;
+	while (num_slots * 2 * sizeof(EvalEntry_t) <= MB(mb)) {
+		num_slots *= 2;
+	}
+
 	entries = new EvalEntry_t[num_slots];
 }
 
@@ -41,9 +53,7 @@ EvaluationTable::~EvaluationTable() {
 /// <param name="key">The position's zobrist hash key.</param>
 /// <param name="eval">The static evaluation of the position.</param>
 void EvaluationTable::store(uint64_t key, int eval) {
-	EvalEntry_t* entry = &entries[key & (num_slots - 1)];
-
-	entry->set(key, eval);
+	entries[key & (num_slots - 1)].write(key, eval);
 }
 
 
@@ -51,18 +61,57 @@ void EvaluationTable::store(uint64_t key, int eval) {
 /// Probe the table to see if a pre-calculated evaluation exists for the position.
 /// </summary>
 /// <param name="key">The position's zobrist hash key.</param>
-/// <param name="hit">A reference to a flag signalling if the got a hit.</param>
-/// <returns>In case of a hit: A pointer to the entry. Otherwise, a null pointer.</returns>
-const EvalEntry_t* EvaluationTable::probe(uint64_t key, bool& hit) {
-	const EvalEntry_t* entry = &entries[key & (num_slots - 1)];
-
-	// Step 1. If the keys match, we have a hit.
-	if (entry->get_key() == (key >> 32)) {
-		hit = true;
-		return entry;
+/// <param name="eval">The stored evaluation in case of a hit.</param>
+/// <param name="stats">Counters of the probing thread. Can be null.</param>
+/// <returns>True if the position was found in the table.</returns>
+bool EvaluationTable::probe(uint64_t key, int& eval, EvalTable_Stats* stats) const {
+	bool hit = entries[key & (num_slots - 1)].read(key, eval);
+
+	if (stats != nullptr) {
+		stats->probes++;
+		stats->hits += hit ? 1 : 0;
+	}
+
+	return hit;
+}
+
+
+
+namespace Eval {
+	namespace {
+		size_t table_mb = EVAL_TABLE_DEFAULT_SIZE;
+		bool table_shared = false;
+
+		// The table used by all threads when it is shared. It is only allocated when needed.
+		std::unique_ptr<EvaluationTable> shared_table;
+		std::mutex table_mutex;
+	}
+
+	void set_table_options(int mb, bool shared) {
+		std::lock_guard<std::mutex> lock(table_mutex);
+
+		table_mb = size_t(std::max(1, mb));
+		table_shared = shared;
+
+		// Release the shared table if it isn't used anymore or has the wrong size. It'll be reallocated by the next search.
+		if (shared_table != nullptr && (!table_shared || shared_table->size() != table_mb)) {
+			shared_table.reset();
+		}
 	}
 
-	// Step 2. Otherwise, return a null pointer.
-	hit = false;
-	return nullptr;
-}
\ No newline at end of file
+	EvaluationTable* acquire_table(bool& owned) {
+		std::lock_guard<std::mutex> lock(table_mutex);
+
+		if (!table_shared) {
+			owned = true;
+			return new EvaluationTable(std::min<size_t>(table_mb, EVAL_TABLE_MAX_THREAD_SIZE));
+		}
+
+		if (shared_table == nullptr) {
+			shared_table = std::make_unique<EvaluationTable>(table_mb);
+		}
+
+		owned = false;
+		return shared_table.get();
+	}
+}
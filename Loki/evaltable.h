@@ -17,29 +17,63 @@
 */
 #ifndef EVALTABLE_H
 #define EVALTABLE_H
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 
+
+
 /// <summary>
-/// The default size of the evaluation hash table in bytes. It is 128KB.
+/// EvalEntry_t is a single entry in the evaluation hash table. Since the table can be shared between all search threads, it uses the same lockless
+/// scheme as the transposition table: The key is stored XOR'ed with the data, such that an entry that has been torn by two threads writing it at the
+/// same time won't validate.
 /// </summary>
-constexpr size_t EVAL_TABLE_SIZE = 128 << 10;
+struct EvalEntry_t {
+	std::atomic<uint64_t> key{ 0 };
+	std::atomic<uint64_t> data{ 0 };
+
+	/// <summary>
+	/// Read the entry and validate it against a position key.
+	/// </summary>
+	/// <param name="pos_key">The position's zobrist hash key.</param>
+	/// <param name="eval">The stored evaluation. Only populated if the entry is valid.</param>
+	/// <returns>True if the entry belongs to the position.</returns>
+	bool read(uint64_t pos_key, int& eval) const {
+		uint64_t raw = data.load(std::memory_order_relaxed);
+
+		if (raw == 0 || (key.load(std::memory_order_relaxed) ^ raw) != pos_key) {
+			return false;
+		}
+
+		eval = int(int32_t(uint32_t(raw)));
+		return true;
+	}
+
+	void write(uint64_t pos_key, int eval) {
+		// A bit in the upper half is set such that the data of an occupied entry is never zero, which is how empty entries are recognized.
+		uint64_t raw = (uint64_t(1) << 32) | uint64_t(uint32_t(eval));
+
+		key.store(pos_key ^ raw, std::memory_order_relaxed);
+		data.store(raw, std::memory_order_relaxed);
+	}
+};
 
 
 
 /// <summary>
-/// EvalEntry_t is the container for the data in a single entry in the evaluation hash table.
+/// EvalTable_Stats holds the evaluation hash table counters of a single Evaluate object (and thereby a single thread).
 /// </summary>
-class EvalEntry_t {
-public:
-	void set(uint64_t pos_key, int eval) { key = pos_key >> 32; score = eval; }
+struct EvalTable_Stats {
+	uint64_t probes = 0;
+	uint64_t hits = 0;
 
-	uint32_t get_key() const { return key; }
-	int get_score() const { return score; }
-private:
-	uint32_t key = 0;
-	int score = 0;
+	void clear() { *this = EvalTable_Stats(); }
 
+	EvalTable_Stats& operator+=(const EvalTable_Stats& other) {
+		probes += other.probes;
+		hits += other.hits;
+		return *this;
+	}
 };
 
 
@@ -49,18 +83,37 @@ private:
 /// </summary>
 class EvaluationTable {
 public:
-	EvaluationTable();
+	EvaluationTable(size_t mb_size);
 	~EvaluationTable();
 
 	void store(uint64_t key, int eval);
-	const EvalEntry_t* probe(uint64_t key, bool& hit);
+	bool probe(uint64_t key, int& eval, EvalTable_Stats* stats = nullptr) const;
+
+	size_t size() const { return mb; }
 
 private:
+	size_t mb = 0;
 	size_t num_slots = 0;
-	EvalEntry_t* entries;
+	EvalEntry_t* entries = nullptr;
 };
 
 
 
+namespace Eval {
+	/// <summary>
+	/// Set the size of the evaluation hash table in MB, and whether all threads share one table or each has its own of that size (capped at
+	/// EVAL_TABLE_MAX_THREAD_SIZE). Only takes effect for threads allocated after the call, see Search::reset_threads.
+	/// </summary>
+	void set_table_options(int mb, bool shared);
+
+	/// <summary>
+	/// Returns the table a new Evaluate object should use. If the table isn't shared, a new one is allocated and owned is set to true,
+	///	meaning the caller has to delete it.
+	/// </summary>
+	EvaluationTable* acquire_table(bool& owned);
+}
+
+
+
 
 #endif
\ No newline at end of file
@@ -159,91 +159,175 @@ const Score weighted_attacks[7] = { S(0, 0), S(53, 51), S(84, 70), S(97, 87), S(
 /*
 Other
 */
-const int max_material[2] = { queen_value.mg + 2 * rook_value.mg + 2 * bishop_value.mg + 2 * knight_value.mg,
-							queen_value.eg + 2 * rook_value.eg + 2 * bishop_value.eg + 2 * knight_value.eg };
+const int max_material[2] = { (queen_value + rook_value * 2 + bishop_value * 2 + knight_value * 2).mg(),
+							(queen_value + rook_value * 2 + bishop_value * 2 + knight_value * 2).eg() };
 
 
 
 namespace Eval {
 
+	/// <summary>
+	/// Get the evaluation hash table. Depending on the EvalHashShared option, it is either a new table for this object or the shared one.
+	/// </summary>
+	template<EvalType T>
+	Evaluate<T>::Evaluate() {
+		eval_table = acquire_table(owns_table);
+	}
+
+	template<EvalType T>
+	Evaluate<T>::~Evaluate() {
+		if (owns_table) { delete eval_table; }
+	}
+
+
 	/// <summary>
 	/// Evaluate a position with a side-relative score.
 	/// </summary>
 	/// <param name="_pos">The position object that is to be evaluated.</param>
+	/// <param name="use_table">Whether or not the evaluation hash table should be probed.</param>
 	/// <returns>A numerical score for the position, relative to the side to move.</returns>
 	template<EvalType T>
 	int Evaluate<T>::score(const GameState_t* _pos, bool use_table) {
+		bool lazy = false;
+		return evaluate(_pos, use_table, -INF, INF, lazy);
+	}
+
+
+	/// <summary>
+	/// Evaluate a position with a side-relative score, but skip the expensive terms if the cheap ones put the score so far outside the window
+	/// that the rest of the evaluation can't bring it back.
+	/// </summary>
+	/// <param name="_pos">The position object that is to be evaluated.</param>
+	/// <param name="alpha">The lower bound of the search window.</param>
+	/// <param name="beta">The upper bound of the search window.</param>
+	/// <param name="lazy">Set to true if the returned score is a lazy estimate. It is then only known to be on the same side of the window as
+	///	the real evaluation.</param>
+	/// <returns>A numerical score for the position, relative to the side to move.</returns>
+	template<EvalType T>
+	int Evaluate<T>::score(const GameState_t* _pos, int alpha, int beta, bool& lazy) {
+		lazy = false;
+		return evaluate(_pos, true, alpha, beta, lazy);
+	}
+
+
+	/// <summary>
+	/// The evaluation itself. See score(...).
+	/// </summary>
+	template<EvalType T>
+	int Evaluate<T>::evaluate(const GameState_t* _pos, bool use_table, int alpha, int beta, bool& lazy) {
 		// Step 1. Clear the object and store the position object.
 		clear();
 		pos = _pos;
 		int v = 0;
 
-		// Step 2. Probe the evaluation hash table for an entry.
-		bool hit = false;
-		const EvalEntry_t* entry = eval_table.probe(pos->posKey, hit);
+		// Step 2. Probe the material hash table. If the material alone tells us that the position is a draw, there is no need to evaluate it.
+		material_entry = material_table.get(pos->materialKey);
 
-		if (use_table && hit) {
-			v = entry->get_score();
+		if (material_entry->key != pos->materialKey) {
+			material_configuration();
 		}
-		else {
-			// Step 3. Evaluate material
-			material<WHITE>();
-			material<BLACK>();
 
-			// Step 4. Evaluate piece placements
-			psqt<WHITE>(); psqt<BLACK>();
+		if (material_entry->flag == INSUFFICIENT_MATERIAL
+			|| (material_entry->flag == DRAW_IF_SAME_COLORED_BISHOPS && pos->insufficient_material())) {
+			return 0;
+		}
 
-			// Step 5. Material imbalances
-			imbalance<WHITE>(); imbalance<BLACK>();
+		// Step 2A. Some endgames are evaluated by a function written specifically for them.
+		if (material_entry->eval_func != nullptr) {
+			v = material_entry->eval_func(pos, material_entry->strong_side);
+			return (pos->side_to_move == material_entry->strong_side) ? v : -v;
+		}
 
-			// Step 6. Pawn structure evaluation
-			pawns<WHITE>(); pawns<BLACK>();
+		// Step 2B. If a network has been loaded and enabled, it replaces the handcrafted evaluation.
+		if (NNUE::active) {
+			return pos->nnue_evaluate();
+		}
+
+		// Step 3. Probe the evaluation hash table for an entry. In case of a hit, the stored evaluation is used as is.
+		if (use_table && eval_table->probe(pos->posKey, v, &table_stats)) {
+			return side_relative(v);
+		}
+
+		// Step 4. Material and piece placements are updated incrementally by the position, and the imbalances are taken from the material
+		//	hash table entry.
+		total += pos->psq_score + material_entry->imbalance;
+
+		// Step 5. Pawn structure evaluation
+		pawn_structure();
+
+		// Step 6. Lazy evaluation. The remaining terms are the most expensive ones, but they very rarely add up to more than lazy_margin. So if the
+		//	score is already that far outside the window, we return it. It isn't stored in the hash table since it isn't the real evaluation.
+		v = side_relative(interpolate());
+
+		if (v + lazy_margin <= alpha || v - lazy_margin >= beta) {
+			lazy = true;
+			return v;
+		}
 
-			// Step 7. Space evaluation
-			space<WHITE>(); space<BLACK>();
+		// Step 7. Space evaluation
+		space<WHITE>(); space<BLACK>();
 
-			// Step 8. Mobility
-			mobility<WHITE, KNIGHT>(); mobility<BLACK, KNIGHT>();
-			mobility<WHITE, BISHOP>(); mobility<BLACK, BISHOP>();
-			mobility<WHITE, ROOK>(); mobility<BLACK, ROOK>();
-			mobility<WHITE, QUEEN>(); mobility<BLACK, QUEEN>();
+		// Step 8. Mobility
+		mobility<WHITE, KNIGHT>(); mobility<BLACK, KNIGHT>();
+		mobility<WHITE, BISHOP>(); mobility<BLACK, BISHOP>();
+		mobility<WHITE, ROOK>(); mobility<BLACK, ROOK>();
+		mobility<WHITE, QUEEN>(); mobility<BLACK, QUEEN>();
 
-			// Step 9. King safety evaluation.
-			king_safety<WHITE>(); king_safety<BLACK>();
+		// Step 9. King safety evaluation.
+		king_safety<WHITE>(); king_safety<BLACK>();
 
-			// Step 10. Compute the phase and interpolate the middle game and endgame scores.
-			int phase = game_phase();
+		// Step 10. All attacks have been generated now, so save the threats against the side to move for the search.
+		if (pos->side_to_move == WHITE) { gather_threats<WHITE>(); }
+		else { gather_threats<BLACK>(); }
 
-			v = (phase * mg_score + (24 - phase) * eg_score) / 24;
+		// Step 11. Interpolate the scores and store the evaluation in the hash table (white's POV)
+		v = interpolate();
+		eval_table->store(pos->posKey, v);
 
-			// Step 11. Store the evaluation in the hash table (white's POV)
-			eval_table.store(pos->posKey, v);
+		// Step 12. Make the score side-relative and return
+		return side_relative(v);
+	}
+
+
+	/// <summary>
+	/// Scale the endgame score by the scale factor of the side that is ahead, and interpolate the middle game and endgame scores by the game phase.
+	/// </summary>
+	/// <returns>The evaluation from white's point of view.</returns>
+	template<EvalType T>
+	int Evaluate<T>::interpolate() {
+		int phase = game_phase();
+		SIDE strong = (total.eg() > 0) ? WHITE : BLACK;
+		int scale = material_entry->scale[strong];
+
+		// A specialised scaling function knows better than the material alone, unless it doesn't recognize the position.
+		if (material_entry->scale_func[strong] != nullptr) {
+			int sf = material_entry->scale_func[strong](pos, strong);
+			scale = (sf != SCALE_NONE) ? sf : scale;
 		}
 
-		// Step 12. Add tempo for the side to move, make the score side-relative and return
-		v += (pos->side_to_move == WHITE) ? tempo : -tempo;
-		v *= (pos->side_to_move == WHITE) ? 1 : -1;
+		return (phase * total.mg() + (24 - phase) * (total.eg() * scale / SCALE_NORMAL)) / 24;
+	}
+
 
-		return v;
+	/// <summary>
+	/// Add tempo for the side to move and make an evaluation from white's point of view relative to the side to move.
+	/// </summary>
+	template<EvalType T>
+	int Evaluate<T>::side_relative(int v) const {
+		v += (pos->side_to_move == WHITE) ? tempo : -tempo;
+		return (pos->side_to_move == WHITE) ? v : -v;
 	}
 
 
 	/// <summary>
-	/// Calculate the game phase based on the amount of material left on the board.
+	/// Get the game phase based on the amount of material left on the board.
 	/// </summary>
 	/// <returns>A number between 0 and 24 representing the game phase.</returns>
 	template<EvalType T>
 	int Evaluate<T>::game_phase() {
-		// We calculate the game phase by giving 1 point for each bishop and knight, 2 for each rook and 4 for each queen.
-		// This gives the starting position a phase of 24.
-		int p = 0;
-
-		p += 1 * (countBits(pos->pieceBBS[KNIGHT][WHITE] | pos->pieceBBS[KNIGHT][BLACK]));
-		p += 1 * (countBits(pos->pieceBBS[BISHOP][WHITE] | pos->pieceBBS[BISHOP][BLACK]));
-		p += 2 * (countBits(pos->pieceBBS[ROOK][WHITE] | pos->pieceBBS[ROOK][BLACK]));
-		p += 4 * (countBits(pos->pieceBBS[QUEEN][WHITE] | pos->pieceBBS[QUEEN][BLACK]));
-
-		return std::min(24, p);
+		// The position keeps count of the phase by giving 1 point for each bishop and knight, 2 for each rook and 4 for each queen.
+		// This gives the starting position a phase of 24, but it can be higher after promotions.
+		return std::min(24, pos->phase);
 	}
 
 
@@ -258,8 +342,10 @@ namespace Eval {
 		Data = ZeroData;
 
 		// Clear the scores and the position pointer.
-		mg_score = eg_score = 0;
+		total = Score(0, 0);
 		pos = nullptr;
+
+		threats.mark_unknown();
 	}
 
 
@@ -268,94 +354,81 @@ namespace Eval {
 	/* --------------------------------------------------------------- */
 
 	/// <summary>
-	/// Evaluate the material on the board for side S.
+	/// Evaluate the material configuration of the position and save it in the material hash table entry. This includes the imbalances and
+	///	the draws and scale factors that can be recognized from the material alone.
 	/// </summary>
-	template<EvalType T> template<SIDE S>
-	void Evaluate<T>::material() {
-		int mg = 0;
-		int eg = 0;
-
-		// Step 1. Get the number of each material type
-		int pawnCnt = countBits(pos->pieceBBS[PAWN][S]);
-		int knightCnt = countBits(pos->pieceBBS[KNIGHT][S]);
-		int bishopCnt = countBits(pos->pieceBBS[BISHOP][S]);
-		int rookCnt = countBits(pos->pieceBBS[ROOK][S]);
-		int queenCnt = countBits(pos->pieceBBS[QUEEN][S]);
-
-		// Step 2. Add middlegame values
-		mg += pawnCnt * pawn_value.mg;
-		mg += knightCnt * knight_value.mg;
-		mg += bishopCnt * bishop_value.mg;
-		mg += rookCnt * rook_value.mg;
-		mg += queenCnt * queen_value.mg;
-
-		// Step 3. Add endgame values
-		eg += pawnCnt * pawn_value.eg;
-		eg += knightCnt * knight_value.eg;
-		eg += bishopCnt * bishop_value.eg;
-		eg += rookCnt * rook_value.eg;
-		eg += queenCnt * queen_value.eg;
-
-
-		// Step 4. Add the values to eval and make it side-dependent
-		mg_score += (S == WHITE) ? mg : -mg;
-		eg_score += (S == WHITE) ? eg : -eg;
-	}
+	template<EvalType T>
+	void Evaluate<T>::material_configuration() {
+		material_entry->key = pos->materialKey;
+		material_entry->imbalance = Score(0, 0);
 
+		// Step 1. Material imbalances.
+		imbalance<WHITE>(); imbalance<BLACK>();
 
-	// Anonymous namespace for adding piece-square-table values.
-	namespace {
-		const Score* tables[6] = { &PSQT::PawnTable[0], &PSQT::KnightTable[0], &PSQT::BishopTable[0], &PSQT::RookTable[0], &PSQT::QueenTable[0], &PSQT::KingTable[0] };
+		// Step 2. Draws by insufficient material. KvK and a lone minor piece against a king are always drawn, while a bishop against a
+		//	bishop is only drawn if they're on squares of the same color, which isn't known from the material.
+		int npm_w = non_pawn_material<MG, WHITE>(pos);
+		int npm_b = non_pawn_material<MG, BLACK>(pos);
+		bool no_pawns = (pos->pieceBBS[PAWN][WHITE] | pos->pieceBBS[PAWN][BLACK]) == 0;
 
-		/// <summary>
-		/// 
-		/// </summary>
-		/// <param name="pce"></param>
-		/// <param name="sq"></param>
-		/// <returns></returns>
-		template<SIDE side, GamePhase p>
-		int addPsqtVal(int pce, int sq) {
-			int v = 0;
+		material_entry->flag = NO_MATERIAL_FLAG;
 
-			assert(p == MG || p == EG);
-			assert(side == WHITE || side == BLACK);
-			assert(sq >= 0 && sq <= 63);
-			assert(pce >= PAWN && pce < NO_TYPE);
-			assert(PSQT::Mirror64[PSQT::Mirror64[sq]] == sq);
+		if (no_pawns && npm_w + npm_b <= bishop_value.mg()) {
+			material_entry->flag = INSUFFICIENT_MATERIAL;
+		}
+		else if (no_pawns && npm_w == bishop_value.mg() && npm_b == bishop_value.mg()
+			&& pos->pieceBBS[BISHOP][WHITE] != 0 && pos->pieceBBS[BISHOP][BLACK] != 0) {
+			material_entry->flag = DRAW_IF_SAME_COLORED_BISHOPS;
+		}
 
-			v += (p == MG) ? tables[pce][(side == WHITE) ? sq : PSQT::Mirror64[sq]].mg : tables[pce][(side == WHITE) ? sq : PSQT::Mirror64[sq]].eg;
+		// Step 3. Scale factors. A side without pawns that is at most a minor piece ahead will have a hard time winning.
+		material_entry->scale[WHITE] = material_entry->scale[BLACK] = SCALE_NORMAL;
 
-			return v;
+		if (pos->pieceBBS[PAWN][WHITE] == 0 && npm_w - npm_b <= bishop_value.mg()) {
+			material_entry->scale[WHITE] = (npm_w < rook_value.mg()) ? SCALE_DRAW : ((npm_b <= bishop_value.mg()) ? 4 : 14);
+		}
+		if (pos->pieceBBS[PAWN][BLACK] == 0 && npm_b - npm_w <= bishop_value.mg()) {
+			material_entry->scale[BLACK] = (npm_b < rook_value.mg()) ? SCALE_DRAW : ((npm_w <= bishop_value.mg()) ? 4 : 14);
 		}
-	} // namespace
 
+		// Step 4. Specialised endgames. The ones with a fixed material are looked up by the material key, and the ones where any number of
+		//	pieces or pawns fits are recognized afterwards.
+		material_entry->eval_func = Endgame::probe_eval(pos->materialKey, material_entry->strong_side);
 
+		for (SIDE side : { WHITE, BLACK }) {
+			SIDE them = (side == WHITE) ? BLACK : WHITE;
+			int npm_us = (side == WHITE) ? npm_w : npm_b;
+			int npm_them = (side == WHITE) ? npm_b : npm_w;
+			bool lone_king = pos->all_pieces[them] == pos->pieceBBS[KING][them];
 
-	/// <summary>
-	/// Evaluate the placement of a side's pieces using piece-square tables.
-	/// </summary>
-	template<EvalType T> template<SIDE S>
-	void Evaluate<T>::psqt() {
-		int mg = 0;
-		int eg = 0;
+			// Step 4A. Mating material against a lone king.
+			if (material_entry->eval_func == nullptr && lone_king && npm_us >= rook_value.mg()) {
+				material_entry->eval_func = Endgame::KXK;
+				material_entry->strong_side = side;
+			}
 
-		Bitboard pceBoard = 0;
-		int sq = NO_SQ;
+			material_entry->scale_func[side] = Endgame::probe_scale(pos->materialKey, side);
 
-		for (int pce = PAWN; pce <= KING; pce++) {
-			pceBoard = pos->pieceBBS[pce][S];
+			if (material_entry->scale_func[side] != nullptr) {
+				continue;
+			}
 
-			while (pceBoard) {
-				sq = PopBit(&pceBoard);
+			// Step 4B. A bishop and pawns against a lone king, where the pawns might be on a rook file with the wrong bishop.
+			if (npm_us == bishop_value.mg() && pos->pieceBBS[BISHOP][side] != 0 && lone_king && pos->pieceBBS[PAWN][side] != 0) {
+				material_entry->scale_func[side] = Endgame::KBPsK;
+			}
 
-				mg += addPsqtVal<S, MG>(pce, sq);
-				eg += addPsqtVal<S, EG>(pce, sq);
+			// Step 4C. Pawns against a lone king.
+			else if (npm_us == 0 && lone_king && countBits(pos->pieceBBS[PAWN][side]) >= 2) {
+				material_entry->scale_func[side] = Endgame::KPsK;
 			}
-		}
 
-		// Add the side-relative scores.
-		mg_score += (S == WHITE) ? mg : -mg;
-		eg_score += (S == WHITE) ? eg : -eg;
+			// Step 4D. A bishop each, possibly on opposite colors.
+			else if (npm_us == bishop_value.mg() && npm_them == bishop_value.mg() && pos->pieceBBS[BISHOP][side] != 0
+				&& pos->pieceBBS[BISHOP][them] != 0 && pos->pieceBBS[PAWN][side] != 0) {
+				material_entry->scale_func[side] = Endgame::KBKB_pawns;
+			}
+		}
 	}
 
 
@@ -365,13 +438,11 @@ namespace Eval {
 	/// </summary>
 	template<EvalType T> template<SIDE S>
 	void Evaluate<T>::imbalance() {
-		int mg = 0;
-		int eg = 0;
+		Score eval(0, 0);
 
 		// Step 1. Bishop pair bonus. FIXME: Should we also have the square-colors of the bishops as a requirement?
 		if (countBits(pos->pieceBBS[BISHOP][S]) >= 2) {
-			mg += bishop_pair.mg;
-			eg += bishop_pair.eg;
+			eval += bishop_pair;
 		}
 
 		int pawns_removed = 8 - countBits(pos->pieceBBS[PAWN][S]);
@@ -379,41 +450,65 @@ namespace Eval {
 		// Step 2. Give rooks bonuses as pawns disappear.
 		int rook_count = countBits(pos->pieceBBS[ROOK][S]);
 
-		mg += rook_count * pawns_removed * rook_pawn_bonus.mg;
-		eg += rook_count * pawns_removed * rook_pawn_bonus.eg;
+		eval += rook_pawn_bonus * (rook_count * pawns_removed);
 
 		// Step 3. Give the knights penalties as pawns dissapear.
 		int knight_count = countBits(pos->pieceBBS[KNIGHT][S]);
 
-		mg -= knight_count * pawns_removed * knight_pawn_penaly.mg;
-		eg -= knight_count * pawns_removed * knight_pawn_penaly.eg;
+		eval -= knight_pawn_penaly * (knight_count * pawns_removed);
+
+		// Step 4. Store the side-relative scores in the material hash table entry.
+		material_entry->imbalance += (S == WHITE) ? eval : -eval;
+	}
+
+
+
+	/// <summary>
+	/// Probe the pawn hash table for the pawn structure, evaluate it if it hasn't been seen before, and apply the scores.
+	/// </summary>
+	template<EvalType T>
+	void Evaluate<T>::pawn_structure() {
+		// Step 1. Look up the entry for the pawn structure. If it belongs to another one, evaluate the pawns and save the result in it.
+		pawn_entry = pawn_table.get(pos->pawnKey);
+
+		if (pawn_entry->key != pos->pawnKey) {
+			pawn_entry->key = pos->pawnKey;
+			pawn_entry->score = Score(0, 0);
+			pawn_entry->king_sq[WHITE] = pawn_entry->king_sq[BLACK] = NO_SQ;
+
+			pawns<WHITE>(); pawns<BLACK>();
+		}
+
+		total += pawn_entry->score;
 
-		// Step 4. Store the side-relative scores.
-		mg_score += (S == WHITE) ? mg : -mg;
-		eg_score += (S == WHITE) ? eg : -eg;
+		// Step 2. Populate the attacks bitboards with the pawn data. This will be used in the evaluation of pieces.
+		for (int side = BLACK; side <= WHITE; side++) {
+			Data.passed_pawns[side] = pawn_entry->passed_pawns[side];
+
+			// Pawns are the first pieces to be evaluated, so the only other attacks are the ones from the king.
+			Data.attacked_by_two[side] = king_ring(pos->king_squares[side]) & pawn_entry->pawn_attacks[side];
+			Data.attacks[side][PAWN] = pawn_entry->pawn_attacks[side];
+		}
+
+		// Step 3. Lastly, evaluate the kings' pawn shelter.
+		king_pawns<WHITE>(); king_pawns<BLACK>();
 	}
 
 
 
 	/// <summary>
 	/// Evaluate the pawn-structure. This includes things like doubled, passed, isolated pawns etc..
+	/// The result only depends on the pawns, so it is saved in the pawn hash table entry instead of being applied directly.
 	/// </summary>
 	template<EvalType T> template<SIDE S>
 	void Evaluate<T>::pawns() {
-		int mg = 0;
-		int eg = 0;
+		Score eval(0, 0);
 
 		// Declare some side-relative constants
-		constexpr Bitboard* passedBitmask = (S == WHITE) ? BBS::EvalBitMasks::passed_pawn_masks[WHITE] : BBS::EvalBitMasks::passed_pawn_masks[BLACK];
-
-		constexpr int relative_ranks[8] = { (S == WHITE) ? RANK_1 : RANK_8, (S == WHITE) ? RANK_2 : RANK_7,
-			(S == WHITE) ? RANK_3 : RANK_6, (S == WHITE) ? RANK_4 : RANK_5, (S == WHITE) ? RANK_5 : RANK_4,
-			(S == WHITE) ? RANK_6 : RANK_3, (S == WHITE) ? RANK_7 : RANK_2, (S == WHITE) ? RANK_8 : RANK_1 };
+		constexpr const Bitboard* passedBitmask = (S == WHITE) ? BBS::EvalBitMasks::passed_pawn_masks[WHITE] : BBS::EvalBitMasks::passed_pawn_masks[BLACK];
 
 		constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
 
-		constexpr DIRECTION downLeft = (S == WHITE) ? SOUTHWEST : NORTHWEST;
-		constexpr DIRECTION downRight = (S == WHITE) ? SOUTHEAST : NORTHEAST;
 		constexpr DIRECTION upLeft = (S == WHITE) ? NORTHWEST : SOUTHWEST;
 		constexpr DIRECTION upRight = (S == WHITE) ? NORTHEAST : SOUTHEAST;
 
@@ -422,6 +517,8 @@ namespace Eval {
 		int sq = NO_SQ;
 		int relative_sq = NO_SQ; // For black it is PSQT::Mirror64[sq] but for white it is just == sq
 
+		Bitboard passed = 0, rear_span = 0;
+
 
 		// Before evaluating all pawns, we will score the amount of doubled pawns by file.
 		int doubled_count = 0;
@@ -429,8 +526,7 @@ namespace Eval {
 			doubled_count += (countBits(BBS::FileMasks8[f] & pos->pieceBBS[PAWN][S]) > 1) ? 1 : 0;
 		}
 
-		mg -= doubled_count * doubled_penalty.mg;
-		eg -= doubled_count * doubled_penalty.eg;
+		eval -= doubled_penalty * doubled_count;
 
 
 		// Now evaluate each individual pawn
@@ -438,16 +534,16 @@ namespace Eval {
 			sq = PopBit(&pawnBoard);
 			relative_sq = (S == WHITE) ? sq : PSQT::Mirror64[sq];
 
-			int r = relative_ranks[sq / 8];
 			int f = sq % 8;
 
+			rear_span |= BBS::EvalBitMasks::rear_span_masks[S][sq];
+
 			// Passed pawn bonus
 			if ((passedBitmask[sq] & pos->pieceBBS[PAWN][Them]) == 0) { // No enemy pawns in front
-				mg += passedPawnTable[relative_sq].mg;
-				eg += passedPawnTable[relative_sq].eg;
+				eval += passedPawnTable[relative_sq];
 
 				// Save the passed pawn's position such that we can give a bonus if it is defended by pieces later.
-				Data.passed_pawns[S] |= (uint64_t(1) << sq);
+				passed |= (uint64_t(1) << sq);
 			}
 
 			// Isolated penalty and/or doubled
@@ -455,25 +551,19 @@ namespace Eval {
 			bool isolated = ((BBS::EvalBitMasks::isolated_bitmasks[f] & pos->pieceBBS[PAWN][S]) == 0) ? true : false;
 
 			if (doubled && isolated) {
-				mg -= doubled_isolated_penalty.mg;
-				eg -= doubled_isolated_penalty.eg;
+				eval -= doubled_isolated_penalty;
 			}
 			else if (isolated) {
-				mg -= isolated_penalty.mg;
-				eg -= isolated_penalty.eg;
+				eval -= isolated_penalty;
 			}
 		}
 
-		// Populate the attacks bitboard with pawn attacks. This will be used in the evaluation of pieces.
-		Data.attacked_by_two[S] = attacked_by_all<S>() & (shift<upRight>(pos->pieceBBS[PAWN][S]) | shift<upLeft>(pos->pieceBBS[PAWN][S]));
-		Data.attacks[S][PAWN] = (shift<upRight>(pos->pieceBBS[PAWN][S]) | shift<upLeft>(pos->pieceBBS[PAWN][S]));
+		// Save the bitboards and the scores in the pawn hash table entry.
+		pawn_entry->passed_pawns[S] = passed;
+		pawn_entry->pawn_attacks[S] = (shift<upRight>(pos->pieceBBS[PAWN][S]) | shift<upLeft>(pos->pieceBBS[PAWN][S]));
+		pawn_entry->rear_span[S] = rear_span;
 
-		// Lastly, evaluate the kings pawn shelter
-		king_pawns<S>();
-
-		// Apply the scores.
-		mg_score += (S == WHITE) ? mg : -mg;
-		eg_score += (S == WHITE) ? eg : -eg;
+		pawn_entry->score += (S == WHITE) ? eval : -eval;
 	}
 
 
@@ -489,8 +579,14 @@ namespace Eval {
 			(S == WHITE) ? RANK_3 : RANK_6, (S == WHITE) ? RANK_4 : RANK_5, (S == WHITE) ? RANK_5 : RANK_4,
 			(S == WHITE) ? RANK_6 : RANK_3, (S == WHITE) ? RANK_7 : RANK_2, (S == WHITE) ? RANK_8 : RANK_1 };
 
-		// Step 1. Variable initialization
-		Score kp_eval, kp_safety;
+		// Step 1. The shelter only depends on the pawns and the king's square, so if the king hasn't moved since it was last computed
+		//	for this pawn structure, we can re-use the score from the pawn hash table.
+		if (pawn_entry->king_sq[S] == pos->king_squares[S]) {
+			total += (S == WHITE) ? pawn_entry->king_score[S] : -pawn_entry->king_score[S];
+			return;
+		}
+
+		Score kp_eval;
 			
 		Bitboard our_pawns = pos->pieceBBS[PAWN][S];
 		Bitboard their_pawns = pos->pieceBBS[PAWN][Them];
@@ -545,9 +641,11 @@ namespace Eval {
 
 		}
 
-		// Lastly, add the eval scores.
-		mg_score += (S == WHITE) ? kp_eval.mg : -kp_eval.mg;
-		eg_score += (S == WHITE) ? kp_eval.eg : -kp_eval.eg;
+		// Lastly, save the score in the pawn hash table entry and add it to the evaluation.
+		pawn_entry->king_sq[S] = king_sq;
+		pawn_entry->king_score[S] = kp_eval;
+
+		total += (S == WHITE) ? kp_eval : -kp_eval;
 	}
 
 
@@ -565,16 +663,8 @@ namespace Eval {
 		constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
 
 		// A space point is given for squares not attacked by enemy pawns and either 1) defended by our own, or 2) behind our own.
-		// Therefore we need to define the rearspan of our pawns.
-		Bitboard rearSpanBrd = 0;
-
-		Bitboard pawnBrd = pos->pieceBBS[PAWN][S];
-		int sq = 0;
-		while (pawnBrd) {
-			sq = PopBit(&pawnBrd);
-
-			rearSpanBrd |= BBS::EvalBitMasks::rear_span_masks[S][sq];
-		}
+		// Therefore we need the rearspan of our pawns, which has been saved in the pawn hash table entry.
+		Bitboard rearSpanBrd = pawn_entry->rear_span[S];
 
 		Bitboard space_zone = war_zone & ~Data.attacks[Them][PAWN]; // Don't consider squares attacked by enemy.
 
@@ -582,8 +672,7 @@ namespace Eval {
 		points += 2 * countBits(rearSpanBrd & space_zone);
 		
 		// Apply the scores based on our space points
-		mg_score += (S == WHITE) ? space_bonus[std::min(31, points)].mg : -space_bonus[std::min(31, points)].mg;
-		eg_score += (S == WHITE) ? space_bonus[std::min(31, points)].eg : -space_bonus[std::min(31, points)].eg;
+		total += (S == WHITE) ? space_bonus[std::min(31, points)] : -space_bonus[std::min(31, points)];
 	}
 
 
@@ -593,8 +682,7 @@ namespace Eval {
 	/// </summary>
 	template<EvalType T> template<SIDE S, piece pce>
 	void Evaluate<T>::mobility() {
-		int mg = 0;
-		int eg = 0;
+		Score eval(0, 0);
 
 		constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
 		constexpr DIRECTION Down = (S == WHITE) ? SOUTH : NORTH;
@@ -643,8 +731,7 @@ namespace Eval {
 				attack_cnt = countBits(piece_attacks);
 				assert(attack_cnt < 9);
 
-				mg += mobility_bonus[pce - 1][attack_cnt].mg;
-				eg += mobility_bonus[pce - 1][attack_cnt].eg;
+				eval += mobility_bonus[pce - 1][attack_cnt];
 			}
 
 			else if constexpr (pce == BISHOP) {
@@ -669,8 +756,7 @@ namespace Eval {
 				attack_cnt = countBits(piece_attacks);
 				assert(attack_cnt < 15);
 
-				mg += mobility_bonus[pce - 1][attack_cnt].mg;
-				eg += mobility_bonus[pce - 1][attack_cnt].eg;
+				eval += mobility_bonus[pce - 1][attack_cnt];
 			}
 
 			else if constexpr (pce == ROOK) {
@@ -693,8 +779,7 @@ namespace Eval {
 
 				attack_cnt = countBits(piece_attacks);
 
-				mg += mobility_bonus[pce - 1][attack_cnt].mg;
-				eg += mobility_bonus[pce - 1][attack_cnt].eg;
+				eval += mobility_bonus[pce - 1][attack_cnt];
 			}
 
 			else if constexpr (pce == QUEEN) {
@@ -718,8 +803,7 @@ namespace Eval {
 				attack_cnt = countBits(piece_attacks);
 				assert(attack_cnt < 29);
 
-				mg += mobility_bonus[pce - 1][attack_cnt].mg;
-				eg += mobility_bonus[pce - 1][attack_cnt].eg;
+				eval += mobility_bonus[pce - 1][attack_cnt];
 			}
 
 			else { // Just in case we went into the loop without a proper piece-type.
@@ -729,8 +813,7 @@ namespace Eval {
 		}
 
 		
-		mg_score += (S == WHITE) ? mg : -mg;
-		eg_score += (S == WHITE) ? eg : -eg;
+		total += (S == WHITE) ? eval : -eval;
 	}
 	
 
@@ -743,21 +826,43 @@ namespace Eval {
 		// Constants
 		constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
 
-		Score safety(0, 0), eval(0, 0);
+		int safety_mg = 0, safety_eg = 0;
 
 		// Step 1. Only evaluate king safety when there are more than two attackers
 		if (Data.king_attackers[S] > 2 || (Data.king_attackers[S] > 1 && pos->pieceBBS[QUEEN][Them] != 0)) {
 
-			safety.mg += (Data.king_attack_value[S] * weighted_attacks[std::clamp(Data.king_attackers[S], 0, 6)].mg) / 100;
-			safety.eg += (Data.king_attack_value[S] * weighted_attacks[std::clamp(Data.king_attackers[S], 0, 6)].eg) / 100;
+			safety_mg += (Data.king_attack_value[S] * weighted_attacks[std::clamp(Data.king_attackers[S], 0, 6)].mg()) / 100;
+			safety_eg += (Data.king_attack_value[S] * weighted_attacks[std::clamp(Data.king_attackers[S], 0, 6)].eg()) / 100;
 		}
 
 		// Step 2. Now convert the safety score to CP.
 		// Note: We do this since very few attackers isn't really a problem, whereas it rises greatly even if one attacker is added.
-		eval = Score(-1 * safety.mg * std::max(0, safety.mg) / 256, -1 * std::max(0, safety.eg) / 64);
+		Score eval(-1 * safety_mg * std::max(0, safety_mg) / 256, -1 * std::max(0, safety_eg) / 64);
 
-		mg_score += (S == WHITE) ? eval.mg : -eval.mg;
-		eg_score += (S == WHITE) ? eval.eg : -eval.eg;
+		total += (S == WHITE) ? eval : -eval;
+	}
+
+
+	/// <summary>
+	/// Save the attacks of the opponent and the pieces of side S that they threaten. Requires that the mobility of all pieces has been evaluated.
+	/// </summary>
+	template<EvalType T> template<SIDE S>
+	void Evaluate<T>::gather_threats() {
+		constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
+
+		Bitboard pieces = pos->all_pieces[S] ^ pos->pieceBBS[PAWN][S] ^ pos->pieceBBS[KING][S];
+		Bitboard majors = pos->pieceBBS[ROOK][S] | pos->pieceBBS[QUEEN][S];
+
+		threats.attacked = attacked_by_all<Them>();
+		threats.pawn_attacked = Data.attacks[Them][PAWN];
+
+		// Pieces attacked by pawns, majors attacked by minors and queens attacked by rooks.
+		threats.threatened = (pieces & Data.attacks[Them][PAWN])
+			| (majors & (Data.attacks[Them][KNIGHT] | Data.attacks[Them][BISHOP]))
+			| (pos->pieceBBS[QUEEN][S] & Data.attacks[Them][ROOK]);
+
+		threats.hanging = pieces & threats.attacked & ~attacked_by_all<S>();
+		threats.valid = true;
 	}
 
 
@@ -771,36 +876,85 @@ namespace Eval {
 			| Data.attacks[S][ROOK] | Data.attacks[S][QUEEN] | king_ring(pos->king_squares[S]));
 	}
 
-	Bitboard king_flanks[8] = { 0 };
+	namespace {
+		/// <summary>
+		/// All squares attacked by one side, including its king ring like attacked_by_all.
+		/// </summary>
+		/// <param name="piece_attacks">Set to the attacks of each piece type.</param>
+		template<SIDE S>
+		Bitboard all_attacks(const GameState_t* pos, Bitboard (&piece_attacks)[6]) {
+			constexpr DIRECTION upLeft = (S == WHITE) ? NORTHWEST : SOUTHWEST;
+			constexpr DIRECTION upRight = (S == WHITE) ? NORTHEAST : SOUTHEAST;
+
+			Bitboard occupied = pos->all_pieces[WHITE] | pos->all_pieces[BLACK];
 
-	/// <summary>
-	/// Initialize the king_flanks array.
-	/// </summary>
-	void initKingFlanks() {
-		for (int f = FILE_A; f <= FILE_H; f++) {
-			if (f < FILE_D) {
-				king_flanks[f] = (BBS::FileMasks8[FILE_A] | BBS::FileMasks8[FILE_B] | BBS::FileMasks8[FILE_C]);
+			piece_attacks[PAWN] = shift<upRight>(pos->pieceBBS[PAWN][S]) | shift<upLeft>(pos->pieceBBS[PAWN][S]);
+			piece_attacks[KING] = king_ring(pos->king_squares[S]);
+
+			Bitboard pceBoard = pos->pieceBBS[KNIGHT][S];
+			piece_attacks[KNIGHT] = 0;
+			while (pceBoard != 0) {
+				piece_attacks[KNIGHT] |= BBS::knight_attacks[PopBit(&pceBoard)];
 			}
-			else if (f == FILE_D) {
-				king_flanks[f] = (BBS::FileMasks8[FILE_C] | BBS::FileMasks8[FILE_D] | BBS::FileMasks8[FILE_E]);
+
+			pceBoard = pos->pieceBBS[BISHOP][S];
+			piece_attacks[BISHOP] = 0;
+			while (pceBoard != 0) {
+				piece_attacks[BISHOP] |= Magics::attacks_bb<BISHOP>(PopBit(&pceBoard), occupied);
 			}
-			else if (f == FILE_E) {
-				king_flanks[f] = (BBS::FileMasks8[FILE_D] | BBS::FileMasks8[FILE_E] | BBS::FileMasks8[FILE_F]);
+
+			pceBoard = pos->pieceBBS[ROOK][S];
+			piece_attacks[ROOK] = 0;
+			while (pceBoard != 0) {
+				piece_attacks[ROOK] |= Magics::attacks_bb<ROOK>(PopBit(&pceBoard), occupied);
 			}
-			else if (f > FILE_E) {
-				king_flanks[f] = (BBS::FileMasks8[FILE_F] | BBS::FileMasks8[FILE_G] | BBS::FileMasks8[FILE_H]);
+
+			pceBoard = pos->pieceBBS[QUEEN][S];
+			piece_attacks[QUEEN] = 0;
+			while (pceBoard != 0) {
+				piece_attacks[QUEEN] |= Magics::attacks_bb<QUEEN>(PopBit(&pceBoard), occupied);
 			}
+
+			return piece_attacks[PAWN] | piece_attacks[KNIGHT] | piece_attacks[BISHOP] | piece_attacks[ROOK] | piece_attacks[QUEEN] | piece_attacks[KING];
 		}
+
+		/// <summary>
+		/// The same as Evaluate::gather_threats, but with the attacks generated here instead of by the evaluation.
+		/// </summary>
+		template<SIDE S>
+		Threats_t compute_threats(const GameState_t* pos) {
+			constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
+
+			Bitboard pieces = pos->all_pieces[S] ^ pos->pieceBBS[PAWN][S] ^ pos->pieceBBS[KING][S];
+			Bitboard majors = pos->pieceBBS[ROOK][S] | pos->pieceBBS[QUEEN][S];
+
+			Bitboard our_attacks[6], their_attacks[6];
+
+			Threats_t threats;
+			threats.attacked = all_attacks<Them>(pos, their_attacks);
+			threats.pawn_attacked = their_attacks[PAWN];
+
+			// Pieces attacked by pawns, majors attacked by minors and queens attacked by rooks.
+			threats.threatened = (pieces & their_attacks[PAWN])
+				| (majors & (their_attacks[KNIGHT] | their_attacks[BISHOP]))
+				| (pos->pieceBBS[QUEEN][S] & their_attacks[ROOK]);
+
+			threats.hanging = pieces & threats.attacked & ~all_attacks<S>(pos, our_attacks);
+			threats.valid = true;
+
+			return threats;
+		}
+	}
+
+
+	Threats_t compute_threats(const GameState_t* pos) {
+		return (pos->side_to_move == WHITE) ? compute_threats<WHITE>(pos) : compute_threats<BLACK>(pos);
 	}
 
+
 	// Explicit Evaluate<> instantiations.
 	template class Evaluate<NORMAL>;
 	template class Evaluate<TRACE>;
-
-	// Initialize the evaulation function. At the moment this is just the king flanks.
-	void INIT() {
-		initKingFlanks();
-	}
 }
 
 
@@ -22,6 +22,9 @@
 #include "movegen.h"
 #include "test_positions.h"
 #include "evaltable.h"
+#include "pawntable.h"
+#include "materialtable.h"
+#include "endgame.h"
 
 
 /*
@@ -30,42 +33,56 @@ Type definitions
 enum GamePhase :int { MG = 0, EG = 1 };
 enum EvalType :int { NORMAL = 0, TRACE = 1 };
 
-class Score {
-public:
-	Score(int m, int e) { mg = m; eg = e; }
-	Score(const Score& s) { mg = s.mg; eg = s.eg; }
-	Score() { mg = 0; eg = 0; }
-	
-	// Some operators.
-	Score& operator+=(const Score& rhs) { this->mg += rhs.mg; this->eg += rhs.eg; return *this;}
-	Score& operator-=(const Score& rhs) { this->mg -= rhs.mg; this->eg -= rhs.eg; return *this;}
-	Score operator+(const Score& rhs) { 
-		Score s;
-		s.mg = mg + rhs.mg; s.eg = eg + rhs.eg;
-		return s;
-	}
-	Score operator-(const Score& rhs) {
-		Score s;
-		s.mg = mg - rhs.mg; s.eg = eg - rhs.eg;
-		return s;
-	}
-
-	int mg = 0;
-	int eg = 0;
-};
-
-
 
 namespace Eval {
 
 	/* Returns true if no checkmate can be forced by either side.
 	bool material_draw(GameState_t* pos);
 	*/
+
+
+	/// <summary>
+	/// Threats_t holds the attack maps of an evaluated position from the side to move's point of view. The search keeps it for every ply such
+	/// that move ordering and pruning can use the attacks without generating them again.
+	/// </summary>
+	struct Threats_t {
+		Bitboard attacked = 0;		// All squares attacked by the opponent.
+		Bitboard pawn_attacked = 0;	// Squares attacked by the opponent's pawns.
+		Bitboard threatened = 0;	// Our pieces (not pawns or king) that are attacked by a less valuable enemy piece.
+		Bitboard hanging = 0;		// Our pieces (not pawns or king) that are attacked and not defended.
+
+		// The attack maps are only generated by a full evaluation or by compute_threats. If this is false, the threats are unknown, and the empty
+		//	bitboards above must not be taken to mean that nothing is threatened.
+		bool valid = false;
+
+		Bitboard safe() const { return ~attacked; }
+		Bitboard en_prise() const { return threatened | hanging; }
+
+		void mark_unknown() { *this = Threats_t(); }
+	};
+
+
+	/// <summary>
+	/// Generate the threats against the side to move without evaluating the position. This gives the same result as a full evaluation, and is
+	/// used by the search when the static evaluation came from a hash table.
+	/// </summary>
+	Threats_t compute_threats(const GameState_t* pos);
+
 	
 	template<EvalType T = NORMAL>
 	class Evaluate {
 	public:
+		Evaluate();
+		~Evaluate();
+
 		int score(const GameState_t* _pos, bool use_table = true);
+		int score(const GameState_t* _pos, int alpha, int beta, bool& lazy);
+
+		const EvalTable_Stats& get_table_stats() const { return table_stats; }
+		void clear_table_stats() { table_stats.clear(); }
+
+		// The threats of the last position that got a full evaluation. Only valid if that was the last position evaluated.
+		const Threats_t& get_threats() const { return threats; }
 
 	private:
 		// The position object that we get when score is called. This is just stored such that all member methods can access it without it being passed as a parameter.
@@ -89,24 +106,26 @@ namespace Eval {
 		};
 		EvalData Data;
 
-		// Scores for middlegame and endgame respectively
-		int mg_score = 0;
-		int eg_score = 0;
+		// The middlegame and endgame scores from white's point of view.
+		Score total;
 
 		// Clear all data from the previous evaluation.
 		void clear();
 
+		int evaluate(const GameState_t* _pos, bool use_table, int alpha, int beta, bool& lazy);
+		int interpolate();
+		int side_relative(int v) const;
+
 		/*
 		Evaluation sub-methods.
 		*/
 		int game_phase();
 
-		template<SIDE S> void material();
-
-		template<SIDE S> void psqt();
+		void material_configuration();
 
 		template<SIDE S> void imbalance();
 
+		void pawn_structure();
 		template<SIDE S> void pawns();
 
 		template<SIDE S> void space();
@@ -116,8 +135,21 @@ namespace Eval {
 		template<SIDE S> void king_safety();
 		template<SIDE S> void king_pawns(); // Called in pawns().
 
-		// An evaluation hash table to re-use recently calculated evaluations.
-		EvaluationTable eval_table;
+		template<SIDE S> void gather_threats();
+		Threats_t threats;
+
+		// An evaluation hash table to re-use recently calculated evaluations. It is either owned by this object or shared with all other threads.
+		EvaluationTable* eval_table = nullptr;
+		bool owns_table = false;
+		EvalTable_Stats table_stats;
+
+		// The pawn hash table and the entry for the position currently being evaluated.
+		PawnTable pawn_table;
+		PawnEntry_t* pawn_entry = nullptr;
+
+		// The material hash table and the entry for the position currently being evaluated.
+		MaterialTable material_table;
+		MaterialEntry_t* material_entry = nullptr;
 
 		//template<SIDE S> Bitboard weak_squares();
 		template<SIDE S> Bitboard attacked_by_all();
@@ -125,15 +157,16 @@ namespace Eval {
 	
 	
 	// The king flanks array is used to determine which pawns to analyze depending on the king's file.
-	extern Bitboard king_flanks[8];
-	
-
-	/*
-	Initialization functions
-	*/
-	void initKingFlanks();
-
-	void INIT();
+	constexpr Bitboard king_flanks[8] = {
+		BBS::FileMasks8[FILE_A] | BBS::FileMasks8[FILE_B] | BBS::FileMasks8[FILE_C],
+		BBS::FileMasks8[FILE_A] | BBS::FileMasks8[FILE_B] | BBS::FileMasks8[FILE_C],
+		BBS::FileMasks8[FILE_A] | BBS::FileMasks8[FILE_B] | BBS::FileMasks8[FILE_C],
+		BBS::FileMasks8[FILE_C] | BBS::FileMasks8[FILE_D] | BBS::FileMasks8[FILE_E],
+		BBS::FileMasks8[FILE_D] | BBS::FileMasks8[FILE_E] | BBS::FileMasks8[FILE_F],
+		BBS::FileMasks8[FILE_F] | BBS::FileMasks8[FILE_G] | BBS::FileMasks8[FILE_H],
+		BBS::FileMasks8[FILE_F] | BBS::FileMasks8[FILE_G] | BBS::FileMasks8[FILE_H],
+		BBS::FileMasks8[FILE_F] | BBS::FileMasks8[FILE_G] | BBS::FileMasks8[FILE_H]
+	};
 
 	/// <summary>
 	/// Used to check that the eval works and doesn't give different values for black and white.
@@ -177,6 +210,7 @@ namespace PSQT {
 
 	// Initializer methods.
 	void initManhattanDistance();
+	void initPsq();
 	extern void INIT();
 }
 
@@ -252,6 +286,9 @@ extern const Score weighted_attacks[7];
 Other constants
 */
 constexpr int tempo = 18;
+
+// If the material, piece-square tables and pawn structure put the score this far outside the window, the remaining terms are skipped.
+constexpr int lazy_margin = 400;
 extern const int max_material[2];
 
 
@@ -315,8 +352,9 @@ template<GamePhase P, SIDE S> inline int non_pawn_material(const GameState_t* po
 	int queenCnt = countBits(pos->pieceBBS[QUEEN][S]);
 
 	// Step 2. Return the non-pawn material.
-	return (P == MG) ? (knightCnt * knight_value.mg + bishopCnt * bishop_value.mg + rookCnt * rook_value.mg + queenCnt * queen_value.mg)
-		: (knightCnt * knight_value.eg + bishopCnt * bishop_value.eg + rookCnt * rook_value.eg + queenCnt * queen_value.eg);
+	Score npm = knight_value * knightCnt + bishop_value * bishopCnt + rook_value * rookCnt + queen_value * queenCnt;
+
+	return (P == MG) ? npm.mg() : npm.eg();
 }
 
 #endif
\ No newline at end of file
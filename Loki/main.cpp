@@ -17,13 +17,22 @@
 */
 #include "texel.h"
 
+#include <thread>
+
 
 int main(int argc, char* argv[]) {
+	// The leaper attacks and evaluation masks are computed at compile time, and the KPK bitbase is built in the background by Endgame::INIT.
+	//	Of the remaining tables, the slider attacks take by far the longest to build, so they are built on their own thread meanwhile.
 	BBS::INIT();
-	Magics::INIT();
+
+	std::thread magics_init(Magics::INIT);
+
 	Search::INIT();
-	Eval::INIT();
 	PSQT::INIT();
+	Endgame::INIT();
+	Numa::INIT();
+
+	magics_init.join();
 
 
 	// If "bench" has been added as an argument, just run this and quit.
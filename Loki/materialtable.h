@@ -0,0 +1,100 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef MATERIALTABLE_H
+#define MATERIALTABLE_H
+#include "defs.h"
+
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// The number of entries in the material hash table. It has to be a power of two.
+/// </summary>
+constexpr size_t MATERIAL_TABLE_ENTRIES = 1 << 12;
+
+/// <summary>
+/// Scale factors for the endgame score. A scale factor of SCALE_NORMAL leaves the score as it is.
+/// </summary>
+constexpr int SCALE_NORMAL = 64;
+constexpr int SCALE_DRAW = 0;
+constexpr int SCALE_NONE = -1; // Returned by scaling functions that don't know the position.
+
+
+class GameState_t;
+
+/// <summary>
+/// Specialised endgame functions (see endgame.h). An evaluation function returns a score relative to the strong side, and a scaling function
+/// returns the scale factor of the strong side's endgame score.
+/// </summary>
+typedef int (*EndgameEval)(const GameState_t* pos, SIDE strong);
+typedef int (*EndgameScale)(const GameState_t* pos, SIDE strong);
+
+
+
+/// <summary>
+/// The different kinds of draws that can be recognized from the material alone.
+/// </summary>
+enum MaterialFlag :int { NO_MATERIAL_FLAG = 0, INSUFFICIENT_MATERIAL = 1, DRAW_IF_SAME_COLORED_BISHOPS = 2 };
+
+
+
+/// <summary>
+/// MaterialEntry_t holds everything the evaluation knows about a material configuration, that is, the number of each piece type for both sides.
+/// </summary>
+struct MaterialEntry_t {
+	uint64_t key = 0;
+
+	// The imbalance score from white's point of view.
+	Score imbalance;
+
+	int flag = NO_MATERIAL_FLAG;
+
+	// The scale factor of the endgame score for the side that is ahead. Indexed by side.
+	int scale[2] = { SCALE_NORMAL, SCALE_NORMAL };
+
+	// The specialised endgame evaluation function, if any, and the side it is for. It replaces the whole evaluation.
+	EndgameEval eval_func = nullptr;
+	SIDE strong_side = WHITE;
+
+	// The specialised scaling functions. Indexed by the side they scale. If they return SCALE_NONE, the scale factor above is used.
+	EndgameScale scale_func[2] = { nullptr, nullptr };
+};
+
+
+
+/// <summary>
+/// MaterialTable is a small per-thread hash table of material configurations, indexed by GameState_t::materialKey. There are very few different
+/// material configurations in a search, so it is almost always hit.
+/// </summary>
+class MaterialTable {
+public:
+	MaterialTable();
+	~MaterialTable();
+
+	/// <summary>
+	/// Get the slot for a material key. The caller must check the key of the entry and fill it in if it doesn't match.
+	/// </summary>
+	MaterialEntry_t* get(uint64_t material_key) { return &entries[material_key & (MATERIAL_TABLE_ENTRIES - 1)]; }
+
+private:
+	MaterialEntry_t* entries = nullptr;
+};
+
+
+
+#endif
@@ -17,6 +17,11 @@
 */
 #include "misc.h"
 
+#include <cstdlib>
+#if (defined(_WIN32) || defined(_WIN64))
+#include <malloc.h>
+#endif
+
 
 
 // I have lost the original link to the source of this function, but I have it from Vice.
@@ -90,4 +95,128 @@ void ReadInput(bool& isStop, bool& isQuit) {
 		}
 		return;
 	}
+}
+
+
+
+/*
+
+large_page_alloc allocates memory for the transposition table. The block is aligned to 2MB such that it can be backed by huge pages, which
+greatly reduces the amount of TLB misses when probing a table of several GB. On Linux we ask for transparent huge pages with madvise, and if the
+kernel refuses (or doesn't support it) we just continue with normal pages. On Windows, large pages require special privileges, so we only align the memory.
+
+*/
+
+void* large_page_alloc(size_t size, bool& huge_pages) {
+	constexpr size_t alignment = size_t(2) << 20;
+
+	// aligned_alloc requires the size to be a multiple of the alignment.
+	size_t alloc_size = ((size + alignment - 1) / alignment) * alignment;
+	huge_pages = false;
+
+#if (defined(_WIN32) || defined(_WIN64))
+	return _aligned_malloc(alloc_size, alignment);
+#else
+	void* mem = std::aligned_alloc(alignment, alloc_size);
+
+	if (mem == nullptr) {
+		return nullptr;
+	}
+
+#if defined(MADV_HUGEPAGE)
+	huge_pages = (madvise(mem, alloc_size, MADV_HUGEPAGE) == 0);
+#endif
+
+	return mem;
+#endif
+}
+
+
+void large_page_free(void* mem) {
+	if (mem == nullptr) {
+		return;
+	}
+
+#if (defined(_WIN32) || defined(_WIN64))
+	_aligned_free(mem);
+#else
+	std::free(mem);
+#endif
+}
+
+
+
+/*
+
+map_file maps a file into memory as read-only. The OS will then page it in as it is read, which is a lot faster than reading it through a stream.
+
+*/
+
+const void* map_file(const std::string& path, size_t& size) {
+	size = 0;
+
+#if (defined(_WIN32) || defined(_WIN64))
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL) {
+		return nullptr;
+	}
+
+	// The view keeps the mapping alive, so the handle can be closed right away.
+	void* mem = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (mem != nullptr) {
+		size = size_t(file_size.QuadPart);
+	}
+	return mem;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return nullptr;
+	}
+
+	void* mem = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mem == MAP_FAILED) {
+		return nullptr;
+	}
+
+	madvise(mem, size_t(st.st_size), MADV_SEQUENTIAL);
+
+	size = size_t(st.st_size);
+	return mem;
+#endif
+}
+
+
+void unmap_file(const void* mem, size_t size) {
+	if (mem == nullptr) {
+		return;
+	}
+
+#if (defined(_WIN32) || defined(_WIN64))
+	(void)size;
+	UnmapViewOfFile(mem);
+#else
+	munmap(const_cast<void*>(mem), size);
+#endif
 }
\ No newline at end of file
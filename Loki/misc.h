@@ -22,6 +22,7 @@
 #include <chrono>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #if (defined(_WIN32) || defined(_WIN64))
 
@@ -36,6 +37,9 @@
 #include <sys/select.h>
 #include <unistd.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #endif
 
 
@@ -52,6 +56,20 @@ inline long long getTimeMs() {
 }
 
 
+// Allocate a large block of memory aligned to 2MB, and ask the OS to back it with (transparent) huge pages if possible.
+// huge_pages is set to whether the request was granted. Returns nullptr if the allocation failed.
+void* large_page_alloc(size_t size, bool& huge_pages);
+
+// Free a block of memory allocated by large_page_alloc.
+void large_page_free(void* mem);
+
+// Memory-map a file for reading. size is set to the size of the file. Returns nullptr if the file couldn't be mapped.
+const void* map_file(const std::string& path, size_t& size);
+
+// Unmap a file mapped with map_file.
+void unmap_file(const void* mem, size_t size);
+
+
 
 
 #endif // ifndef MISC_H
\ No newline at end of file
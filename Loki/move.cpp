@@ -134,6 +134,16 @@ void MoveList::replace(int index, Move_t newMove) {
 	moveList[index] = newMove;
 }
 
+/// <summary>
+/// Removes a move from the movelist by overwriting it with the last one. This doesn't preserve the order of the moves.
+/// </summary>
+/// <param name="index">: The index of the move to remove.</param>
+void MoveList::remove(int index) {
+	assert(moveList + index < last);
+
+	*(moveList + index) = *(--last);
+}
+
 /// <summary>
 /// Checks if a move is in the movelist.
 /// </summary>
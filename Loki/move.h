@@ -28,10 +28,14 @@
 	QUIET: All moves that do not capture a piece or promote.
 	CASTLE: All castling moves.
 	ALL: All pseudo-legal moves in the position.
-	EVASIONS: If we're in check, we'll only generate the legal check evasion moves
+	LEGAL: All legal moves in the position. These are the pseudo-legal moves that pass GameState_t::is_legal.
+	EVASIONS: If we're in check, we'll only generate the moves that can get us out of it. These are king moves to squares that aren't attacked
+		by the checking sliders, and, if there is only one checker, captures of it and interpositions. The moves are pseudo-legal, since
+		pinned pieces aren't excluded.
+	QUIET_CHECKS: All moves that don't capture, promote or castle, and give check, either directly or by discovery.
 
 */
-enum MoveType :int { CAPTURES = 0, QUIET = 1, CASTLE = 2, ALL = 3};
+enum MoveType :int { CAPTURES = 0, QUIET = 1, CASTLE = 2, ALL = 3, LEGAL = 4, EVASIONS = 5, QUIET_CHECKS = 6};
 
 /*
 With these commands we can get information about a Move_t.move.
@@ -61,6 +65,7 @@ public:
 
 	Move_t at(int index);
 	void replace(int index, Move_t newMove);
+	void remove(int index);
 
 	void reset() {
 		last = moveList;
@@ -20,6 +20,14 @@
 
 
 namespace moveGen {
+
+	// The squares a piece other than the king can move to in order to get out of a single check: The checking piece and the squares between it
+	//	and the king.
+	inline Bitboard evasion_targets(const GameState_t* pos) {
+		return BBS::between_bb[pos->king_squares[pos->side_to_move]][bitScanForward(pos->checkers)] | pos->checkers;
+	}
+
+
 	template <MoveType type, SIDE me>
 	void generate_pawn_moves(GameState_t* pos, MoveList* move_list) {
 
@@ -151,6 +159,95 @@ namespace moveGen {
 			return;
 		}
 
+		// When evading a single check, the pawns can only push to a square between the checker and the king, or capture the checker.
+		else if constexpr (type == EVASIONS) {
+			Bitboard target = evasion_targets(pos);
+
+			Bitboard one_up = shift<Up>(pawnBrd) & ~OCCUPIED;
+			Bitboard two_up = shift<Up>(one_up & RankThree) & ~OCCUPIED & target;
+			one_up &= target;
+
+			Bitboard blocking_promotions = one_up & ~NotRankEight;
+			one_up &= NotRankEight;
+
+			Bitboard left_attacks = shift<upLeft>(pawnBrd) & pos->checkers;
+			Bitboard right_attacks = shift<upRight>(pawnBrd) & pos->checkers;
+
+			while (one_up != 0) {
+				index = PopBit(&one_up);
+
+				move_list->add_move(index, (me == WHITE ? index - 8 : index + 8), 0, NOT_SPECIAL);
+			}
+
+			while (two_up != 0) {
+				index = PopBit(&two_up);
+
+				move_list->add_move(index, (me == WHITE ? index - 16 : index + 16), 0, NOT_SPECIAL);
+			}
+
+			while (blocking_promotions) {
+				index = PopBit(&blocking_promotions);
+
+				for (int p = 0; p < 4; p++) {
+					move_list->add_move(index, ((me == WHITE) ? index - 8 : index + 8), p, PROMOTION);
+				}
+			}
+
+			while (left_attacks) {
+				index = PopBit(&left_attacks);
+
+				if ((uint64_t(1) << index) & ~NotRankEight) {
+					for (int p = 0; p < 4; p++) {
+						move_list->add_move(index, index - left_attack_origin, p, PROMOTION);
+					}
+				}
+				else {
+					move_list->add_move(index, index - left_attack_origin, 0, NOT_SPECIAL);
+				}
+			}
+
+			while (right_attacks) {
+				index = PopBit(&right_attacks);
+
+				if ((uint64_t(1) << index) & ~NotRankEight) {
+					for (int p = 0; p < 4; p++) {
+						move_list->add_move(index, index - right_attack_origin, p, PROMOTION);
+					}
+				}
+				else {
+					move_list->add_move(index, index - right_attack_origin, 0, NOT_SPECIAL);
+				}
+			}
+
+			// An en-passant capture evades the check if the checker is the pawn that just moved two squares up, or if the capturing pawn
+			//	blocks a slider.
+			if (pos->enPasSq != NO_SQ) {
+				Bitboard epBrd = uint64_t(1) << pos->enPasSq;
+				Bitboard capturedBrd = (me == WHITE) ? epBrd >> 8 : epBrd << 8;
+
+				if ((pos->checkers & capturedBrd) != 0 || (target & epBrd) != 0) {
+					if constexpr (me == WHITE) {
+						if (((epBrd & ~BBS::FileMasks8[FILE_A]) >> 9) & pawnBrd) {
+							move_list->add_move(pos->enPasSq, pos->enPasSq - 9, 0, ENPASSANT);
+						}
+						if (((epBrd & ~BBS::FileMasks8[FILE_H]) >> 7) & pawnBrd) {
+							move_list->add_move(pos->enPasSq, pos->enPasSq - 7, 0, ENPASSANT);
+						}
+					}
+					else {
+						if (((epBrd & ~BBS::FileMasks8[FILE_A]) << 7) & pawnBrd) {
+							move_list->add_move(pos->enPasSq, pos->enPasSq + 7, 0, ENPASSANT);
+						}
+						if (((epBrd & ~BBS::FileMasks8[FILE_H]) << 9) & pawnBrd) {
+							move_list->add_move(pos->enPasSq, pos->enPasSq + 9, 0, ENPASSANT);
+						}
+					}
+				}
+			}
+
+			return;
+		}
+
 		else {
 			Bitboard one_up = (shift<Up>(pawnBrd) & ~OCCUPIED) & NotRankEight;
 
@@ -299,7 +396,24 @@ namespace moveGen {
 			}
 		}
 
-		// For knights, if it isn't captures or quiets, it is ALL
+		else if constexpr (type == EVASIONS) {
+			Bitboard target = evasion_targets(pos);
+
+			while (knightBrd) {
+				index = PopBit(&knightBrd);
+
+				// When evading a check, the knight has to capture the checker or block it.
+				attack_board = BBS::knight_attacks[index] & target;
+
+				while (attack_board) {
+					attack_sq = PopBit(&attack_board);
+
+					move_list->add_move(attack_sq, index, 0, NOT_SPECIAL);
+				}
+			}
+		}
+
+		// For knights, if it isn't captures, quiets or evasions, it is ALL
 		else {
 
 			while (knightBrd) {
@@ -369,6 +483,24 @@ namespace moveGen {
 			return;
 		}
 
+		else if constexpr (type == EVASIONS) {
+			Bitboard target = evasion_targets(pos);
+
+			while (sliderBrd) {
+				sq = PopBit(&sliderBrd);
+
+				// If we are evading a check, we have to capture the checker or block it.
+				attacks = (Magics::attacks_bb<pce>(sq, occupied)) & target;
+
+				while (attacks) {
+					dest = PopBit(&attacks);
+
+					move_list->add_move(dest, sq, 0, NOT_SPECIAL);
+				}
+			}
+			return;
+		}
+
 
 		else { // ALL
 			while (sliderBrd) {
@@ -463,6 +595,28 @@ namespace moveGen {
 			return;
 		}
 
+		else if constexpr (type == EVASIONS) {
+			// The king can't castle out of check, and it can't step away from a checking slider along the line it is checking on. The other
+			//	squares are left for GameState_t::is_legal to check.
+			Bitboard slider_checkers = pos->checkers & ~(pos->pieceBBS[PAWN][(me == WHITE) ? BLACK : WHITE] | pos->pieceBBS[KNIGHT][(me == WHITE) ? BLACK : WHITE]);
+			Bitboard slider_lines = 0;
+
+			while (slider_checkers) {
+				sq = PopBit(&slider_checkers);
+
+				slider_lines |= BBS::line_bb[sq][kingSq] & ~(uint64_t(1) << sq);
+			}
+
+			attackBrd = BBS::king_attacks[kingSq] & ~friendly_pieces & ~slider_lines;
+
+			while (attackBrd) {
+				sq = PopBit(&attackBrd);
+
+				move_list->add_move(sq, kingSq, 0, NOT_SPECIAL);
+			}
+			return;
+		}
+
 		else { // MoveType is ALL
 			gen_castle_moves<me>(pos, move_list);
 			attackBrd = BBS::king_attacks[pos->king_squares[me]] & ~friendly_pieces;
@@ -477,8 +631,123 @@ namespace moveGen {
 	}
 
 	
+	/// <summary>
+	/// Generate the quiet moves that give check. A move gives a direct check if it lands on a square from which the piece attacks the enemy
+	/// king, and a discovered check if the piece is the only one between one of our sliders and the king, and leaves the line between them.
+	/// </summary>
+	template <SIDE me>
+	void generate_quiet_checks(GameState_t* pos, MoveList* move_list) {
+		constexpr SIDE Them = (me == WHITE) ? BLACK : WHITE;
+		constexpr DIRECTION Up = (me == WHITE) ? NORTH : SOUTH;
+		constexpr Bitboard NotRankEight = (me == WHITE) ? ~BBS::RankMasks8[RANK_8] : ~BBS::RankMasks8[RANK_1];
+		constexpr Bitboard RankThree = (me == WHITE) ? BBS::RankMasks8[RANK_3] : BBS::RankMasks8[RANK_6];
+
+		int king_sq = pos->king_squares[Them];
+		Bitboard occupied = pos->all_pieces[WHITE] | pos->all_pieces[BLACK];
+		Bitboard empty = ~occupied;
+		Bitboard kingBrd = uint64_t(1) << king_sq;
+
+		// Step 1. Find the squares each piece type gives check from. For pawns, these are the squares that a pawn of the enemy king's color on
+		//	the king's square would attack.
+		Bitboard check_squares[5] = { 0 };
+		check_squares[PAWN] = (me == WHITE) ? (shift<SOUTHWEST>(kingBrd) | shift<SOUTHEAST>(kingBrd)) : (shift<NORTHWEST>(kingBrd) | shift<NORTHEAST>(kingBrd));
+		check_squares[KNIGHT] = BBS::knight_attacks[king_sq];
+		check_squares[BISHOP] = Magics::attacks_bb<BISHOP>(king_sq, occupied);
+		check_squares[ROOK] = Magics::attacks_bb<ROOK>(king_sq, occupied);
+		check_squares[QUEEN] = check_squares[BISHOP] | check_squares[ROOK];
+
+		Bitboard discoverers = pos->discovered_check_candidates<me>();
+
+		int from = 0;
+		int to = 0;
+		Bitboard moves = 0;
+
+		// Step 2. Pawn pushes. Promotions are left out since they are generated as captures.
+		Bitboard pawnBrd = pos->pieceBBS[PAWN][me];
+		Bitboard one_up = shift<Up>(pawnBrd) & empty & NotRankEight;
+		Bitboard two_up = shift<Up>(one_up & RankThree) & empty;
+
+		while (one_up) {
+			to = PopBit(&one_up);
+			from = (me == WHITE) ? to - 8 : to + 8;
+
+			if ((check_squares[PAWN] & (uint64_t(1) << to)) || ((discoverers & (uint64_t(1) << from)) && !(BBS::line_bb[from][king_sq] & (uint64_t(1) << to)))) {
+				move_list->add_move(to, from, 0, NOT_SPECIAL);
+			}
+		}
+
+		while (two_up) {
+			to = PopBit(&two_up);
+			from = (me == WHITE) ? to - 16 : to + 16;
+
+			if ((check_squares[PAWN] & (uint64_t(1) << to)) || ((discoverers & (uint64_t(1) << from)) && !(BBS::line_bb[from][king_sq] & (uint64_t(1) << to)))) {
+				move_list->add_move(to, from, 0, NOT_SPECIAL);
+			}
+		}
+
+		// Step 3. Knights and sliders. A discovering piece checks from any square off the line to the king.
+		for (int pce = KNIGHT; pce <= QUEEN; pce++) {
+			Bitboard pieces = pos->pieceBBS[pce][me];
+
+			while (pieces) {
+				from = PopBit(&pieces);
+
+				moves = (pce == KNIGHT) ? BBS::knight_attacks[from]
+					: (pce == BISHOP) ? Magics::attacks_bb<BISHOP>(from, occupied)
+					: (pce == ROOK) ? Magics::attacks_bb<ROOK>(from, occupied)
+					: Magics::attacks_bb<QUEEN>(from, occupied);
+
+				moves &= empty & (((discoverers & (uint64_t(1) << from)) ? ~BBS::line_bb[from][king_sq] : 0) | check_squares[pce]);
+
+				while (moves) {
+					to = PopBit(&moves);
+
+					move_list->add_move(to, from, 0, NOT_SPECIAL);
+				}
+			}
+		}
+
+		// Step 4. The king can only give a discovered check.
+		from = pos->king_squares[me];
+
+		if (discoverers & (uint64_t(1) << from)) {
+			moves = BBS::king_attacks[from] & empty & ~BBS::line_bb[from][king_sq];
+
+			while (moves) {
+				to = PopBit(&moves);
+
+				move_list->add_move(to, from, 0, NOT_SPECIAL);
+			}
+		}
+	}
+
+	
 	template <MoveType type, SIDE me>
-	void generate_all(GameState_t* pos, MoveList* move_list) {		
+	void generate_all(GameState_t* pos, MoveList* move_list) {
+		if constexpr (type == QUIET_CHECKS) {
+			generate_quiet_checks<me>(pos, move_list);
+
+			return;
+		}
+
+		// When evading a check, the king moves are generated first since they are the only ones possible in a double check.
+		if constexpr (type == EVASIONS) {
+			generate_king_moves<type, me>(pos, move_list);
+
+			if ((pos->checkers & (pos->checkers - 1)) != 0) {
+				return;
+			}
+
+			generate_pawn_moves<type, me>(pos, move_list);
+			generate_knight_moves<type, me>(pos, move_list);
+
+			generate_piece_moves<BISHOP, type, me>(pos, move_list);
+			generate_piece_moves<ROOK, type, me>(pos, move_list);
+			generate_piece_moves<QUEEN, type, me>(pos, move_list);
+
+			return;
+		}
+
 		generate_pawn_moves<type, me>(pos, move_list);
 		generate_knight_moves<type, me>(pos, move_list);
 
@@ -551,6 +820,34 @@ void moveGen::generate<CAPTURES>(GameState_t* pos, MoveList* move_list) {
 }
 
 
+template<>
+void moveGen::generate<EVASIONS>(GameState_t* pos, MoveList* move_list) {
+	SIDE me = pos->side_to_move;
+
+	assert(pos->checkers != 0);
+
+	if (me == WHITE) {
+		generate_all<EVASIONS, WHITE>(pos, move_list);
+	}
+	else {
+		generate_all<EVASIONS, BLACK>(pos, move_list);
+	}
+}
+
+
+template<>
+void moveGen::generate<QUIET_CHECKS>(GameState_t* pos, MoveList* move_list) {
+	SIDE me = pos->side_to_move;
+
+	if (me == WHITE) {
+		generate_all<QUIET_CHECKS, WHITE>(pos, move_list);
+	}
+	else {
+		generate_all<QUIET_CHECKS, BLACK>(pos, move_list);
+	}
+}
+
+
 template<>
 void moveGen::generate<QUIET>(GameState_t* pos, MoveList* move_list) {
 	SIDE me = pos->side_to_move;
@@ -561,4 +858,30 @@ void moveGen::generate<QUIET>(GameState_t* pos, MoveList* move_list) {
 	else {
 		generate_all<QUIET, BLACK>(pos, move_list);
 	}
-}
\ No newline at end of file
+}
+
+
+/// <summary>
+/// Generate all legal moves. The pseudo-legal moves, or the evasions if we're in check, are generated first, and those that leave the king in
+/// check are removed. Moves already in the list are kept.
+/// </summary>
+template<>
+void moveGen::generate<LEGAL>(GameState_t* pos, MoveList* move_list) {
+	int first = move_list->size();
+
+	if (pos->checkers != 0) {
+		generate<EVASIONS>(pos, move_list);
+	}
+	else {
+		generate<ALL>(pos, move_list);
+	}
+
+	for (int i = first; i < move_list->size();) {
+		if (!pos->is_legal((*move_list)[i]->move)) {
+			move_list->remove(i);
+		}
+		else {
+			i++;
+		}
+	}
+}
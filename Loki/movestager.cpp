@@ -30,20 +30,21 @@ MoveStager::MoveStager(GameState_t* _pos, MoveStats_t* _stats, unsigned int ttMo
 	pos = _pos;
 	stats = _stats;
 
-	// If there is a move from the transposition table, set stage to tt stage, otherwise to capture stage.
+	// If there is a move from the transposition table, set stage to tt stage, otherwise to capture stage. If we're in check, the evasion stages
+	//	are used instead.
 	tt_move = ttMove;
 	if (ttMove != NOMOVE) {
-		stage = TT_STAGE;
+		stage = (in_check) ? EVASION_TT_STAGE : TT_STAGE;
 
 		// Since there is a risk of key collisions, we need to check that the tt move is at least pseudo-legal.
 		// If the move isn't pseudo-legal set a new stage.
 		if (!is_pseudo_legal(pos, tt_move, in_check)) {
-			stage = CAPTURE_SCORE_STAGE;
+			stage = (in_check) ? EVASION_SCORE_STAGE : CAPTURE_SCORE_STAGE;
 			tt_move = NOMOVE;
 		}
 	}
 	else {
-		stage = CAPTURE_SCORE_STAGE;
+		stage = (in_check) ? EVASION_SCORE_STAGE : CAPTURE_SCORE_STAGE;
 	}
 }
 
@@ -52,10 +53,23 @@ MoveStager::MoveStager(GameState_t* _pos, MoveStats_t* _stats, unsigned int ttMo
 /// A constructor for use in quiescence search. The movestats are excluded since we wont be using them in quiescence where only captures are searched.
 /// </summary>
 /// <param name="_pos">A position object to use for generating moves.</param>
-MoveStager::MoveStager(GameState_t* _pos) {
+/// <param name="ttMove">A capture from the quiescence table. It will be searched first.</param>
+/// <param name="in_check">A flag signalling if we're in check or not.</param>
+/// <param name="quiet_checks">A flag signalling if the quiet moves that give check should be generated after the captures.</param>
+MoveStager::MoveStager(GameState_t* _pos, unsigned int ttMove, bool in_check, bool quiet_checks) {
 	pos = _pos;
+	generate_checks = quiet_checks;
 
-	stage = CAPTURE_SCORE_STAGE;
+	// As in the main search, the tt move has to be checked for pseudo-legality since the table can have collisions. If we're in check, all
+	//	evasions are generated instead of the captures.
+	tt_move = ttMove;
+	if (ttMove != NOMOVE && is_pseudo_legal(pos, tt_move, in_check)) {
+		stage = (in_check) ? EVASION_TT_STAGE : TT_STAGE;
+	}
+	else {
+		stage = (in_check) ? EVASION_SCORE_STAGE : CAPTURE_SCORE_STAGE;
+		tt_move = NOMOVE;
+	}
 }
 
 
@@ -114,6 +128,7 @@ top:
 	switch (stage) {
 
 	case TT_STAGE:
+	case EVASION_TT_STAGE:
 		move.move = tt_move;
 		move.score = hash_move_sort;
 
@@ -156,8 +171,12 @@ top:
 		return true;
 
 	case QUIET_SCORE_STAGE:
-		// If we should skip the quiets, return false since there are no moves after these.
+		// If we should skip the quiets, return false since there are no moves after these. The quiet checks can still be searched though.
 		if (skip_quiets) {
+			if (generate_checks) {
+				stage = QUIET_CHECK_SCORE_STAGE;
+				goto top;
+			}
 			return false;
 		}
 		
@@ -199,6 +218,72 @@ top:
 	case NO_STAGE:
 		return false;
 
+	case QUIET_CHECK_SCORE_STAGE:
+		// Score and generate the quiet checks. They are added after the captures, so current_move is at the first of them.
+		score<QUIET_CHECKS>();
+
+		if (current_move >= ml.size()) {
+			stage = NO_STAGE;
+			return false;
+		}
+
+		stage++;
+		[[fallthrough]];
+
+	case QUIET_CHECK_STAGE:
+		// Step 1. Find the best move and insert it.
+		pi_sort();
+		move.move = ml[current_move]->move;
+		move.score = ml[current_move]->score;
+
+		// Step 2. Increment the current move. If there are no more checks, we're done.
+		current_move++;
+
+		if (current_move >= ml.size()) {
+			stage = NO_STAGE;
+		}
+
+		// Step 3. If the move we found was the TT move, we don't want to search it. Find another one.
+		if (move.move == tt_move) {
+			goto top;
+		}
+
+		return true;
+
+	case EVASION_SCORE_STAGE:
+		// Score and generate the evasions. If there are none, we're mated.
+		score<EVASIONS>();
+		current_move = 0;
+
+		if (ml.size() == 0) {
+			stage = NO_STAGE;
+			return false;
+		}
+
+		stage++;
+		[[fallthrough]];
+
+	case EVASION_STAGE:
+		// The evasions are returned even if quiets should be skipped, since we'd otherwise miss that we're mated.
+		// Step 1. Find the best move and insert it.
+		pi_sort();
+		move.move = ml[current_move]->move;
+		move.score = ml[current_move]->score;
+
+		// Step 2. Increment the current move. The evasions are the last moves, so if there are no more, we're done.
+		current_move++;
+
+		if (current_move >= ml.size()) {
+			stage = NO_STAGE;
+		}
+
+		// Step 3. If the move we found was the TT move, we don't want to search it. Find another one.
+		if (move.move == tt_move) {
+			goto top;
+		}
+
+		return true;
+
 	// If the stage isn't one of the above, an error has occured.
 	default:
 		assert(false);
@@ -20,13 +20,20 @@
 #include "thread.h"
 
 // This is all the stages we generate the moves in. In the future, it would be nice to split the captures.
+// When in check, the moves are generated in the evasion stages instead, which end in NO_STAGE too. In quiescence search, the quiet checks can
+// be generated after the captures.
 enum STAGE_T :int {
 	TT_STAGE = 0,
 	CAPTURE_SCORE_STAGE = 1,
 	CAPTURE_STAGE = 2,
 	QUIET_SCORE_STAGE = 3,
 	QUIET_STAGE = 4,
-	NO_STAGE = 5
+	NO_STAGE = 5,
+	EVASION_TT_STAGE = 6,
+	EVASION_SCORE_STAGE = 7,
+	EVASION_STAGE = 8,
+	QUIET_CHECK_SCORE_STAGE = 9,
+	QUIET_CHECK_STAGE = 10
 };
 
 
@@ -39,7 +46,7 @@ class MoveStager {
 public:
 	MoveStager();
 	MoveStager(GameState_t* _pos, MoveStats_t* _stats, unsigned int ttMove, bool in_check); // For main search
-	MoveStager(GameState_t* _pos); // For quiescence search.
+	MoveStager(GameState_t* _pos, unsigned int ttMove = NOMOVE, bool in_check = false, bool quiet_checks = false); // For quiescence search.
 	
 	bool next_move(Move_t& move, bool skip_quiets = false);
 
@@ -57,6 +64,9 @@ protected:
 
 	unsigned int tt_move = NOMOVE;
 
+	// If true, the quiet checks are generated when the quiets are skipped.
+	bool generate_checks = false;
+
 	void pi_sort();
 };
 
@@ -73,7 +83,7 @@ public:
 
 
 /// <summary>
-/// Method for generating and scoring all moves. The two templates are for captures and quiets separately.
+/// Method for generating and scoring all moves. The templates are for captures, quiets and check evasions separately.
 /// </summary>
 /// <param name="raise_captures">A flag used to give captures a higher score than quiets (+10M). Used when generating all moves at once.</param>
 template<MoveType T>
@@ -97,6 +107,51 @@ void MoveStager::score(bool raise_captures) {
 			}
 
 			// Step 2B. History (~243 elo).
+			else {
+				ml[i]->score = stats->history[pos->side_to_move][FROMSQ(ml[i]->move)][TOSQ(ml[i]->move)];
+
+				// Step 2C. If the static evaluation found one of our pieces to be en prise, moving it away is probably a good idea.
+				const Eval::Threats_t& threats = stats->threats[pos->ply];
+
+				if (threats.valid && (threats.en_prise() & (uint64_t(1) << FROMSQ(ml[i]->move)))
+					&& !(threats.pawn_attacked & (uint64_t(1) << TOSQ(ml[i]->move)))) {
+					ml[i]->score += threat_escape_bonus;
+				}
+			}
+		}
+	}
+	else if constexpr (T == QUIET_CHECKS) {
+		// Step 1. Generate the quiet checks after the captures.
+		moveGen::generate<QUIET_CHECKS>(pos, &ml);
+
+		// Step 2. Score them by SEE, such that checks that lose the moved piece are searched last, and can be pruned. Since nothing is captured,
+		//	the score is never above zero.
+		for (int i = current_move; i < ml.size(); i++) {
+			ml[i]->score = pos->see(ml[i]->move);
+		}
+	}
+	else if constexpr (T == EVASIONS) {
+		// Step 1. Generate the check evasions. These are the only moves generated in the node.
+		moveGen::generate<EVASIONS>(pos, &ml);
+
+		// Step 2. Captures of the checking piece are searched first, ordered by MvvLva. The king moves and interpositions are ordered by the
+		//	killers and history, which aren't available in quiescence search.
+		for (int i = 0; i < ml.size(); i++) {
+			int piece_moved = pos->piece_list[pos->side_to_move][FROMSQ(ml[i]->move)];
+			int piece_captured = (SPECIAL(ml[i]->move) == ENPASSANT) ? PAWN : pos->piece_list[Them][TOSQ(ml[i]->move)];
+
+			if (piece_captured != NO_TYPE) {
+				ml[i]->score = 10000000 + MvvLva[piece_moved][piece_captured];
+			}
+			else if (stats == nullptr) {
+				ml[i]->score = 0;
+			}
+			else if (ml[i]->move == stats->killers[pos->ply][0]) {
+				ml[i]->score = first_killer;
+			}
+			else if (ml[i]->move == stats->killers[pos->ply][1]) {
+				ml[i]->score = second_killer;
+			}
 			else {
 				ml[i]->score = stats->history[pos->side_to_move][FROMSQ(ml[i]->move)][TOSQ(ml[i]->move)];
 			}
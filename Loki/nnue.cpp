@@ -0,0 +1,291 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "nnue.h"
+#include "bitboard.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+#if defined(__AVX2__)
+#define NNUE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NNUE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace NNUE {
+
+	bool active = false;
+	uint32_t generation = 0;
+
+
+	namespace {
+
+		/// <summary>
+		/// The quantized weights of the network. The file contains them in this order, as little-endian 16-bit integers.
+		/// </summary>
+		struct Network {
+			alignas(64) int16_t feature_weights[INPUT_SIZE][HIDDEN_SIZE];
+			alignas(64) int16_t feature_bias[HIDDEN_SIZE];
+			alignas(64) int16_t output_weights[2][HIDDEN_SIZE];
+			int16_t output_bias;
+		};
+
+		// The size of a network file without padding.
+		constexpr size_t NETWORK_FILE_SIZE = sizeof(int16_t) * (INPUT_SIZE * HIDDEN_SIZE + HIDDEN_SIZE + 2 * HIDDEN_SIZE + 1);
+
+		Network net;
+		bool loaded = false;
+		bool enabled = false;
+
+
+		// The feature index of a piece (see Delta) from each perspective. Black sees the board flipped, with its own pieces first.
+		inline int white_feature(int piece) { return (piece >= 384) ? piece - 384 : piece + 384; }
+		inline int black_feature(int piece) { return piece ^ 56; }
+
+
+		/*
+		SIMD kernels. All of them work on whole rows of HIDDEN_SIZE values, which is a multiple of the register width.
+		*/
+#if defined(NNUE_AVX2)
+		typedef __m256i vec_t;
+		constexpr int VEC_SIZE = 16;
+
+		inline vec_t vec_load(const int16_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+		inline void vec_store(int16_t* p, vec_t v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+		inline vec_t vec_add_16(vec_t a, vec_t b) { return _mm256_add_epi16(a, b); }
+		inline vec_t vec_sub_16(vec_t a, vec_t b) { return _mm256_sub_epi16(a, b); }
+		inline vec_t vec_add_32(vec_t a, vec_t b) { return _mm256_add_epi32(a, b); }
+		inline vec_t vec_madd_16(vec_t a, vec_t b) { return _mm256_madd_epi16(a, b); }
+		inline vec_t vec_clamp(vec_t v) { return _mm256_min_epi16(_mm256_max_epi16(v, _mm256_setzero_si256()), _mm256_set1_epi16(QA)); }
+		inline vec_t vec_zero() { return _mm256_setzero_si256(); }
+
+		inline int vec_hsum_32(vec_t v) {
+			__m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+			s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+			s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_cvtsi128_si32(s);
+		}
+#elif defined(NNUE_SSE2)
+		typedef __m128i vec_t;
+		constexpr int VEC_SIZE = 8;
+
+		inline vec_t vec_load(const int16_t* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+		inline void vec_store(int16_t* p, vec_t v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+		inline vec_t vec_add_16(vec_t a, vec_t b) { return _mm_add_epi16(a, b); }
+		inline vec_t vec_sub_16(vec_t a, vec_t b) { return _mm_sub_epi16(a, b); }
+		inline vec_t vec_add_32(vec_t a, vec_t b) { return _mm_add_epi32(a, b); }
+		inline vec_t vec_madd_16(vec_t a, vec_t b) { return _mm_madd_epi16(a, b); }
+		inline vec_t vec_clamp(vec_t v) { return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(QA)); }
+		inline vec_t vec_zero() { return _mm_setzero_si128(); }
+
+		inline int vec_hsum_32(vec_t s) {
+			s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+			s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_cvtsi128_si32(s);
+		}
+#endif
+
+#if defined(NNUE_AVX2) || defined(NNUE_SSE2)
+		static_assert(HIDDEN_SIZE % VEC_SIZE == 0, "HIDDEN_SIZE must be a multiple of the SIMD register width.");
+
+		/// <summary>
+		/// out = in + the sum of the added rows - the sum of the removed rows.
+		/// </summary>
+		inline void apply_rows(int16_t* out, const int16_t* in, const int* added, int add_count, const int* removed, int remove_count) {
+			for (int i = 0; i < HIDDEN_SIZE; i += VEC_SIZE) {
+				vec_t v = vec_load(&in[i]);
+
+				for (int a = 0; a < add_count; a++) {
+					v = vec_add_16(v, vec_load(&net.feature_weights[added[a]][i]));
+				}
+				for (int r = 0; r < remove_count; r++) {
+					v = vec_sub_16(v, vec_load(&net.feature_weights[removed[r]][i]));
+				}
+
+				vec_store(&out[i], v);
+			}
+		}
+
+		/// <summary>
+		/// The dot product of the clipped accumulator with a row of output weights.
+		/// </summary>
+		inline int output_dot(const int16_t* acc, const int16_t* weights) {
+			vec_t sum = vec_zero();
+
+			for (int i = 0; i < HIDDEN_SIZE; i += VEC_SIZE) {
+				// The clipped values are at most QA, so the products of two neighbours always fit in the 32-bit lanes.
+				sum = vec_add_32(sum, vec_madd_16(vec_clamp(vec_load(&acc[i])), vec_load(&weights[i])));
+			}
+
+			return vec_hsum_32(sum);
+		}
+#else
+		inline void apply_rows(int16_t* out, const int16_t* in, const int* added, int add_count, const int* removed, int remove_count) {
+			for (int i = 0; i < HIDDEN_SIZE; i++) {
+				int v = in[i];
+
+				for (int a = 0; a < add_count; a++) { v += net.feature_weights[added[a]][i]; }
+				for (int r = 0; r < remove_count; r++) { v -= net.feature_weights[removed[r]][i]; }
+
+				out[i] = int16_t(v);
+			}
+		}
+
+		inline int output_dot(const int16_t* acc, const int16_t* weights) {
+			int sum = 0;
+
+			for (int i = 0; i < HIDDEN_SIZE; i++) {
+				sum += std::clamp(int(acc[i]), 0, QA) * weights[i];
+			}
+
+			return sum;
+		}
+#endif
+	}
+
+
+
+	/// <summary>
+	/// Load a network from a file.
+	/// </summary>
+	/// <param name="path">The path of the network file.</param>
+	/// <returns>True if the network was loaded.</returns>
+	bool load(const std::string& path) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+		// Step 1. Make sure the file exists and holds a network of our architecture. Trainers commonly pad the file to a multiple of 64 bytes,
+		//	so it is allowed to be slightly larger.
+		if (!file.is_open()) {
+			return false;
+		}
+
+		size_t file_size = size_t(file.tellg());
+
+		if (file_size < NETWORK_FILE_SIZE || file_size >= NETWORK_FILE_SIZE + 64) {
+			return false;
+		}
+
+		// Step 2. Read the weights into a temporary network, such that a failed read doesn't leave us with half a network.
+		std::unique_ptr<Network> tmp(new Network);
+		file.seekg(0);
+
+		file.read(reinterpret_cast<char*>(tmp->feature_weights), sizeof(tmp->feature_weights));
+		file.read(reinterpret_cast<char*>(tmp->feature_bias), sizeof(tmp->feature_bias));
+		file.read(reinterpret_cast<char*>(tmp->output_weights), sizeof(tmp->output_weights));
+		file.read(reinterpret_cast<char*>(&tmp->output_bias), sizeof(tmp->output_bias));
+
+		if (!file) {
+			return false;
+		}
+
+		// Step 3. Replace the network and invalidate all accumulators computed with the old one.
+		net = *tmp;
+		loaded = true;
+
+		set_enabled(enabled);
+
+		return true;
+	}
+
+
+	/// <summary>
+	/// Enable or disable the network.
+	/// </summary>
+	void set_enabled(bool _enabled) {
+		enabled = _enabled;
+		active = enabled && loaded;
+
+		// The accumulators haven't been updated while the network was disabled, so none of them can be trusted anymore.
+		generation++;
+	}
+
+
+	/// <summary>
+	/// Compute an accumulator from scratch by adding the features of all pieces on the board to the biases.
+	/// </summary>
+	void refresh(Accumulator& acc, const Bitboard pieceBBS[6][2]) {
+		// There can't be more than 32 pieces on the board.
+		int white_features[32];
+		int black_features[32];
+		int count = 0;
+
+		for (int side = BLACK; side <= WHITE; side++) {
+			for (int pce = PAWN; pce <= KING; pce++) {
+				Bitboard pceBrd = pieceBBS[pce][side];
+
+				while (pceBrd) {
+					int piece = side * 384 + pce * 64 + PopBit(&pceBrd);
+
+					white_features[count] = white_feature(piece);
+					black_features[count] = black_feature(piece);
+					count++;
+				}
+			}
+		}
+
+		apply_rows(acc.values[WHITE], net.feature_bias, white_features, count, nullptr, 0);
+		apply_rows(acc.values[BLACK], net.feature_bias, black_features, count, nullptr, 0);
+		acc.generation = generation;
+	}
+
+
+	/// <summary>
+	/// Compute the accumulator after a move from the one before it. If that one isn't valid, the new one isn't either.
+	/// </summary>
+	void update(Accumulator& acc, const Accumulator& prev, const Delta& delta) {
+		if (prev.generation != generation) {
+			acc.generation = 0;
+			return;
+		}
+
+		int added[2], removed[2];
+
+		for (int a = 0; a < delta.add_count; a++) { added[a] = white_feature(delta.added[a]); }
+		for (int r = 0; r < delta.remove_count; r++) { removed[r] = white_feature(delta.removed[r]); }
+		apply_rows(acc.values[WHITE], prev.values[WHITE], added, delta.add_count, removed, delta.remove_count);
+
+		for (int a = 0; a < delta.add_count; a++) { added[a] = black_feature(delta.added[a]); }
+		for (int r = 0; r < delta.remove_count; r++) { removed[r] = black_feature(delta.removed[r]); }
+		apply_rows(acc.values[BLACK], prev.values[BLACK], added, delta.add_count, removed, delta.remove_count);
+
+		acc.generation = generation;
+	}
+
+
+	/// <summary>
+	/// Run the output layer on an accumulator.
+	/// </summary>
+	/// <param name="acc">The accumulator of the position. It has to be valid.</param>
+	/// <param name="stm">The side to move.</param>
+	/// <returns>The evaluation in centipawns, relative to the side to move.</returns>
+	int evaluate(const Accumulator& acc, SIDE stm) {
+		assert(acc.generation == generation);
+		SIDE Them = (stm == WHITE) ? BLACK : WHITE;
+
+		int output = output_dot(acc.values[stm], net.output_weights[0]) + output_dot(acc.values[Them], net.output_weights[1]);
+
+		// Both the sum and the bias are quantized by QA * QB.
+		int v = int((int64_t(output) + net.output_bias) * OUTPUT_SCALE / (QA * QB));
+
+		return std::clamp(v, -EVAL_LIMIT, EVAL_LIMIT);
+	}
+}
@@ -0,0 +1,99 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef NNUE_H
+#define NNUE_H
+#include "defs.h"
+
+#include <cstdint>
+#include <string>
+
+
+/*
+An efficiently updatable neural network, which can be used instead of the handcrafted evaluation.
+
+The architecture is (768 -> HIDDEN_SIZE) x 2 -> 1. The input layer has a feature for each piece type of each side on each square, and is
+evaluated once from each side's perspective. The two resulting accumulators are clipped to [0, QA], concatenated with the side to move's
+first, and fed to a single output neuron.
+Since a move only changes a few features, the accumulators are updated incrementally by GameState_t::make_move, and undo_move simply goes
+back to the previous accumulator.
+*/
+namespace NNUE {
+
+	constexpr int INPUT_SIZE = 768;
+	constexpr int HIDDEN_SIZE = 256;
+
+	// Quantization of the weights. The input layer is scaled by QA and the output layer by QB. The output is then scaled to centipawns.
+	constexpr int QA = 255;
+	constexpr int QB = 64;
+	constexpr int OUTPUT_SCALE = 400;
+
+	// The evaluation is clamped such that it can never be mistaken for a mate score.
+	constexpr int EVAL_LIMIT = 20000;
+
+
+	/// <summary>
+	/// The first layer's output for both perspectives. It belongs to the network generation it was computed with, and is recomputed if that
+	/// isn't the current one.
+	/// </summary>
+	struct alignas(64) Accumulator {
+		int16_t values[2][HIDDEN_SIZE];
+		uint32_t generation = 0;
+	};
+
+
+	/// <summary>
+	/// Delta holds the features that are added and removed by a move. A move never adds or removes more than two pieces.
+	/// </summary>
+	struct Delta {
+		int added[2] = { 0 };
+		int removed[2] = { 0 };
+		int add_count = 0;
+		int remove_count = 0;
+
+		// The pieces are saved as side * 384 + piece * 64 + square, from which the feature index of each perspective is derived.
+		void add(int side, int pce, int sq) { added[add_count++] = side * 384 + pce * 64 + sq; }
+		void remove(int side, int pce, int sq) { removed[remove_count++] = side * 384 + pce * 64 + sq; }
+	};
+
+
+	// True if a network has been loaded and it is enabled. In this case, the accumulators are updated and the network is used for evaluation.
+	extern bool active;
+
+	// Incremented every time a network is loaded or enabled, such that all accumulators computed before then are invalidated.
+	extern uint32_t generation;
+
+
+	// Load a network from a file. Returns false, and keeps the previous network, if the file can't be read or has the wrong size.
+	bool load(const std::string& path);
+
+	// Enable or disable the network. It is only active if a network has been loaded.
+	void set_enabled(bool enabled);
+
+
+	// Compute the accumulator from scratch.
+	void refresh(Accumulator& acc, const Bitboard pieceBBS[6][2]);
+
+	// Compute the accumulator of a position from the one before a move and the features it changed.
+	void update(Accumulator& acc, const Accumulator& prev, const Delta& delta);
+
+	// Run the output layer. Returns a score relative to the side to move.
+	int evaluate(const Accumulator& acc, SIDE stm);
+}
+
+
+#endif
@@ -0,0 +1,167 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "numa.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+
+namespace Numa {
+
+	namespace {
+		bool numa_enabled = false;
+
+		// The CPUs of each node. If the topology couldn't be read, this holds a single node with no CPUs, meaning "don't bind".
+		std::vector<std::vector<int>> node_cpus = { {} };
+
+		// The ids of the nodes in node_cpus.
+		std::vector<int> node_ids = { 0 };
+
+
+		// Parse a Linux cpu/node list like "0-3,8-11" into the numbers it contains.
+		std::vector<int> parse_list(const std::string& list) {
+			std::vector<int> numbers;
+			std::stringstream ss(list);
+			std::string range;
+
+			while (std::getline(ss, range, ',')) {
+				if (range.empty() || range == "\n") {
+					continue;
+				}
+
+				size_t dash = range.find('-');
+				int first = std::stoi(range.substr(0, dash));
+				int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+
+				for (int n = first; n <= last; n++) {
+					numbers.push_back(n);
+				}
+			}
+
+			return numbers;
+		}
+
+		std::string read_line(const std::string& path) {
+			std::ifstream file(path);
+			std::string line;
+			std::getline(file, line);
+			return line;
+		}
+	}
+
+
+	void INIT() {
+#if defined(__linux__)
+		// Step 1. Find the online nodes.
+		std::string online = read_line("/sys/devices/system/node/online");
+		if (online.empty()) {
+			return;
+		}
+
+		std::vector<int> ids = parse_list(online);
+		std::vector<std::vector<int>> cpus;
+
+		// Step 2. Find the CPUs of each node. Nodes without CPUs (memory-only nodes) can't run threads, but their memory is still interleaved.
+		for (int id : ids) {
+			cpus.push_back(parse_list(read_line("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist")));
+		}
+
+		if (!ids.empty()) {
+			node_ids = ids;
+			node_cpus = cpus;
+		}
+#endif
+	}
+
+
+	int node_count() {
+		return int(node_ids.size());
+	}
+
+
+	void set_enabled(bool enable) {
+		numa_enabled = enable;
+	}
+
+	bool enabled() {
+		return numa_enabled;
+	}
+
+
+	void interleave(void* mem, size_t size) {
+#if defined(__linux__) && defined(SYS_mbind)
+		if (!numa_enabled || node_count() < 2 || mem == nullptr) {
+			return;
+		}
+
+		// Build the node mask. We call mbind directly to avoid depending on libnuma, so MPOL_INTERLEAVE is defined here.
+		constexpr int MPOL_INTERLEAVE_POLICY = 3;
+		constexpr int bits = 8 * sizeof(unsigned long);
+
+		int max_node = 0;
+		for (int id : node_ids) {
+			max_node = std::max(max_node, id);
+		}
+
+		std::vector<unsigned long> mask(max_node / bits + 1, 0);
+		for (int id : node_ids) {
+			mask[id / bits] |= 1UL << (id % bits);
+		}
+
+		syscall(SYS_mbind, mem, size, MPOL_INTERLEAVE_POLICY, mask.data(), (unsigned long)(mask.size() * bits + 1), 0);
+#else
+		(void)mem;
+		(void)size;
+#endif
+	}
+
+
+	void bind_thread(int thread_id) {
+#if defined(__linux__)
+		if (!numa_enabled || node_count() < 2) {
+			return;
+		}
+
+		const std::vector<int>& cpus = node_cpus[thread_id % node_count()];
+		if (cpus.empty()) {
+			return;
+		}
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (int cpu : cpus) {
+			if (cpu < CPU_SETSIZE) {
+				CPU_SET(cpu, &set);
+			}
+		}
+
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+#else
+		(void)thread_id;
+#endif
+	}
+}
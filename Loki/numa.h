@@ -0,0 +1,54 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef NUMA_H
+#define NUMA_H
+#include <cstddef>
+#include <vector>
+
+
+/*
+
+The Numa namespace holds the (optional) support for machines with multiple NUMA nodes. When enabled, the transposition table's pages are interleaved
+across all nodes, so no single memory controller has to serve every probe, and each search thread is bound to the CPUs of one node.
+The topology is read from /sys/devices/system/node on Linux. On other systems (or if the topology can't be read) a single node is assumed, and
+everything below is a no-op.
+
+*/
+
+namespace Numa {
+
+	// Read the NUMA topology of the machine. Called once at startup from main().
+	void INIT();
+
+	// The amount of NUMA nodes found by INIT().
+	int node_count();
+
+	// Enable or disable NUMA support. This is set with the "NUMA" UCI option.
+	void set_enabled(bool enable);
+	bool enabled();
+
+	// Interleave the pages of a block of memory across all nodes. The memory has to be page-aligned, and the policy only affects pages that
+	// haven't been touched yet, so this has to be called right after allocation.
+	void interleave(void* mem, size_t size);
+
+	// Bind the calling thread to the CPUs of a node. Search threads are spread round-robin over the nodes by their id.
+	void bind_thread(int thread_id);
+}
+
+
+#endif
@@ -0,0 +1,40 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "pawntable.h"
+
+
+
+/// <summary>
+/// Allocate the entries and mark them as empty.
+/// </summary>
+PawnTable::PawnTable() {
+	static_assert((PAWN_TABLE_ENTRIES & (PAWN_TABLE_ENTRIES - 1)) == 0, "PAWN_TABLE_ENTRIES must be a power of two.");
+	entries = new PawnEntry_t[PAWN_TABLE_ENTRIES];
+
+	// A position without pawns has a pawn key of zero, so the empty entries would be mistaken for it. Invalidate them.
+	for (size_t i = 0; i < PAWN_TABLE_ENTRIES; i++) {
+		entries[i].key = ~uint64_t(0);
+	}
+}
+
+/// <summary>
+/// Destructor. Frees the memory allocated during construction.
+/// </summary>
+PawnTable::~PawnTable() {
+	if (entries != nullptr) { delete[] entries; }
+}
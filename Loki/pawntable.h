@@ -0,0 +1,74 @@
+/*
+	Loki, a UCI-compliant chess playing software
+	Copyright (C) 2021  Niels Abildskov (https://github.com/BimmerBass)
+
+	Loki is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Loki is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef PAWNTABLE_H
+#define PAWNTABLE_H
+#include "defs.h"
+
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// The number of entries in the pawn hash table. It has to be a power of two.
+/// </summary>
+constexpr size_t PAWN_TABLE_ENTRIES = 1 << 12;
+
+
+
+/// <summary>
+/// PawnEntry_t holds everything the evaluation knows about a pawn structure. All of it only depends on the pawns, except for the king shelter
+/// which also depends on the king's square, so that is cached together with the square it was computed for.
+/// </summary>
+struct PawnEntry_t {
+	uint64_t key = 0;
+
+	// The pawn structure score from white's point of view.
+	Score score;
+
+	// Bitboards indexed by side.
+	Bitboard passed_pawns[2] = { 0 };
+	Bitboard pawn_attacks[2] = { 0 };
+	Bitboard rear_span[2] = { 0 };			// All squares behind the pawns.
+
+	// The king shelter score (relative to the side) and the king square it was computed for.
+	int king_sq[2] = { NO_SQ, NO_SQ };
+	Score king_score[2];
+};
+
+
+
+/// <summary>
+/// PawnTable is a small per-thread hash table of pawn structures, indexed by GameState_t::pawnKey. Since the pawn structure changes rarely
+/// during the search, almost all probes will hit.
+/// </summary>
+class PawnTable {
+public:
+	PawnTable();
+	~PawnTable();
+
+	/// <summary>
+	/// Get the slot for a pawn key. The caller must check the key of the entry and fill it in if it doesn't match.
+	/// </summary>
+	PawnEntry_t* get(uint64_t pawn_key) { return &entries[pawn_key & (PAWN_TABLE_ENTRIES - 1)]; }
+
+private:
+	PawnEntry_t* entries = nullptr;
+};
+
+
+
+#endif
@@ -47,16 +47,24 @@ namespace Perft {
 			}
 #endif
 
-			MoveList moves; moveGen::generate<ALL>(pos, &moves);
+			MoveList moves; moveGen::generate<LEGAL>(pos, &moves);
 
 #if defined(PERFT_TT) // Just a pedantic suppression of C4189 when not using perft_tt
 			long long previous_cnt = leaf_count;
 #endif
 
+			// The moves are legal, so at depth one the number of leaves is just the number of moves.
+			if (depth == 1) {
+				leaf_count += moves.size();
+
+#if defined(PERFT_TT)
+				pt->store_entry(pos->posKey, depth, leaf_count - previous_cnt);
+#endif
+				return;
+			}
+
 			for (int m = 0; m < moves.size(); m++) {
-				if (!pos->make_move(moves[m])) {
-					continue;
-				}
+				pos->make_move(moves[m]);
 
 				perft(pos, depth - 1);
 
@@ -78,16 +86,14 @@ namespace Perft {
 		std::cout << "Starting perft test to depth " << depth << std::endl;
 
 
-		MoveList moves; moveGen::generate<ALL>(pos, &moves);
+		MoveList moves; moveGen::generate<LEGAL>(pos, &moves);
 
 		std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now();
 
 		int legal = 0;
 
 		for (int m = 0; m < moves.size(); m++) {
-			if (!pos->make_move(moves[m])) {
-				continue;
-			}
+			pos->make_move(moves[m]);
 
 			legal += 1;
 			long long old_nodes = leaf_count;
@@ -41,6 +41,8 @@ bool GameState_t::can_castle<BQCA>() {
 
 void GameState_t::generate_poskey() {
 	posKey = 0;
+	pawnKey = 0;
+	materialKey = 0;
 	
 	int index = 0;
 	for (int pce = PAWN; pce < NO_TYPE; pce++) {
@@ -60,6 +62,27 @@ void GameState_t::generate_poskey() {
 		}
 	}
 
+	Bitboard pawnBrd = pieceBBS[PAWN][WHITE];
+	while (pawnBrd) {
+		pawnKey ^= BBS::Zobrist::piece_keys[WHITE][PAWN][PopBit(&pawnBrd)];
+	}
+
+	pawnBrd = pieceBBS[PAWN][BLACK];
+	while (pawnBrd) {
+		pawnKey ^= BBS::Zobrist::piece_keys[BLACK][PAWN][PopBit(&pawnBrd)];
+	}
+
+	// The material key uses the piece keys indexed by count instead of square, such that n pieces of a type are hashed with the keys 0..n-1.
+	// The kings are left out since there is always one of each.
+	for (int pce = PAWN; pce <= QUEEN; pce++) {
+		for (int cnt = 0; cnt < countBits(pieceBBS[pce][WHITE]); cnt++) {
+			materialKey ^= BBS::Zobrist::piece_keys[WHITE][pce][cnt];
+		}
+		for (int cnt = 0; cnt < countBits(pieceBBS[pce][BLACK]); cnt++) {
+			materialKey ^= BBS::Zobrist::piece_keys[BLACK][pce][cnt];
+		}
+	}
+
 	if (enPasSq != NO_SQ) {
 		posKey ^= BBS::Zobrist::empty_keys[enPasSq];
 	}
@@ -69,6 +92,36 @@ void GameState_t::generate_poskey() {
 	posKey ^= BBS::Zobrist::castling_keys[castleRights];
 }
 
+
+void GameState_t::generate_psq() {
+	psq_score = Score(0, 0);
+	phase = 0;
+
+	for (int pce = PAWN; pce < NO_TYPE; pce++) {
+		for (int side = BLACK; side <= WHITE; side++) {
+			Bitboard pceBrd = pieceBBS[pce][side];
+
+			while (pceBrd) {
+				psq_score += PSQT::psq[side][pce][PopBit(&pceBrd)];
+				phase += phase_values[pce];
+			}
+		}
+	}
+}
+
+
+int GameState_t::nnue_evaluate() const {
+	ensure_accumulators();
+	NNUE::Accumulator& acc = accumulators[history_ply];
+
+	// If the accumulator couldn't be updated incrementally, compute it from scratch. The positions after it are then updated from this one.
+	if (acc.generation != NNUE::generation) {
+		NNUE::refresh(acc, pieceBBS);
+	}
+
+	return NNUE::evaluate(acc, side_to_move);
+}
+
 void GameState_t::displayBoardState() {
 	std::string output = "................................................................";
 	int index = 0;
@@ -156,8 +209,20 @@ void GameState_t::clearPos() {
 	fiftyMove = 0;
 
 	posKey = 0;
+	pawnKey = 0;
+	materialKey = 0;
+
+	psq_score = Score(0, 0);
+	phase = 0;
+
+	checkers = 0;
+	pinned = 0;
 
 	history_ply = 0;
+
+	if (!accumulators.empty()) {
+		accumulators[0].generation = 0;
+	}
 }
 
 
@@ -296,8 +361,11 @@ void GameState_t::parseFen(const std::string FEN_STR) {
 		| pieceBBS[QUEEN][BLACK] | pieceBBS[KING][BLACK]);
 
 
-	// Generate the position hash key
+	// Generate the position hash key and the material and piece-square table score.
 	generate_poskey();
+	generate_psq();
+
+	update_check_info();
 }
 
 
@@ -357,7 +425,86 @@ bool GameState_t::square_attacked(int square, SIDE side) const {
 
 // Returns true if the side to move is in check
 bool GameState_t::in_check() const {
-	return (side_to_move == WHITE) ? square_attacked(king_squares[WHITE], BLACK) : square_attacked(king_squares[BLACK], WHITE);
+	return checkers != 0;
+}
+
+
+/// <summary>
+/// Get the pieces of one side that attack a square.
+/// </summary>
+/// <param name="sq">The square.</param>
+/// <param name="side">The side whose attackers we want.</param>
+/// <param name="occupied">The occupancy to use for the slider attacks. This doesn't have to be the one on the board.</param>
+Bitboard GameState_t::attackers_of(int sq, SIDE side, Bitboard occupied) const {
+	Bitboard sqBrd = uint64_t(1) << sq;
+
+	// A pawn attacks the square if a pawn of the other side on it would attack the pawn.
+	Bitboard pawn_attacks = (side == WHITE) ? (shift<SOUTHWEST>(sqBrd) | shift<SOUTHEAST>(sqBrd)) : (shift<NORTHWEST>(sqBrd) | shift<NORTHEAST>(sqBrd));
+
+	return (pawn_attacks & pieceBBS[PAWN][side])
+		| (BBS::knight_attacks[sq] & pieceBBS[KNIGHT][side])
+		| (BBS::king_attacks[sq] & pieceBBS[KING][side])
+		| (Magics::attacks_bb<BISHOP>(sq, occupied) & (pieceBBS[BISHOP][side] | pieceBBS[QUEEN][side]))
+		| (Magics::attacks_bb<ROOK>(sq, occupied) & (pieceBBS[ROOK][side] | pieceBBS[QUEEN][side]));
+}
+
+
+/// <summary>
+/// Compute the checkers and pinned pieces of the side to move. This is done whenever the side to move changes.
+/// </summary>
+void GameState_t::update_check_info() {
+	SIDE Them = (side_to_move == WHITE) ? BLACK : WHITE;
+
+	checkers = attackers_of(king_squares[side_to_move], Them, all_pieces[WHITE] | all_pieces[BLACK]);
+	pinned = (side_to_move == WHITE) ? pinned_pieces<WHITE>() : pinned_pieces<BLACK>();
+}
+
+
+/// <summary>
+/// Determine if a pseudo-legal move is legal, that is, if it doesn't leave our king in check. Most moves are known to be legal from the
+/// checkers and pinned pieces alone, so the board only has to be looked at for king moves and en-passant captures.
+/// </summary>
+/// <param name="move">The move. It has to be pseudo-legal.</param>
+/// <returns>True if the move is legal.</returns>
+bool GameState_t::is_legal(unsigned int move) const {
+	SIDE Them = (side_to_move == WHITE) ? BLACK : WHITE;
+	int origin = FROMSQ(move);
+	int destination = TOSQ(move);
+	int king_sq = king_squares[side_to_move];
+	Bitboard occupied = all_pieces[WHITE] | all_pieces[BLACK];
+
+	// Step 1. En-passant captures remove two pieces from their squares, which can uncover an attack on the king along the rank. These are so rare
+	//	that we just see if the king is attacked after the move. The captured pawn can't attack anything anymore.
+	if (SPECIAL(move) == ENPASSANT) {
+		int captured_sq = (side_to_move == WHITE) ? destination - 8 : destination + 8;
+		Bitboard occupied_after = (occupied ^ (uint64_t(1) << origin) ^ (uint64_t(1) << captured_sq)) | (uint64_t(1) << destination);
+
+		return (attackers_of(king_sq, Them, occupied_after) & ~(uint64_t(1) << captured_sq)) == 0;
+	}
+
+	// Step 2. Castling moves are only generated if the king doesn't pass or land on an attacked square.
+	if (SPECIAL(move) == CASTLING) {
+		return true;
+	}
+
+	// Step 3. The king can't move to an attacked square. It is removed from the board such that it can't hide from a slider behind itself.
+	if (origin == king_sq) {
+		return attackers_of(destination, Them, occupied ^ (uint64_t(1) << origin)) == 0;
+	}
+
+	// Step 4. In check, other pieces have to capture the checking piece or block the check. Only the king can move out of a double check.
+	if (checkers != 0) {
+		if ((checkers & (checkers - 1)) != 0) {
+			return false;
+		}
+
+		if (((BBS::between_bb[king_sq][bitScanForward(checkers)] | checkers) & (uint64_t(1) << destination)) == 0) {
+			return false;
+		}
+	}
+
+	// Step 5. A pinned piece can only move along the line between the pinner and the king.
+	return (pinned & (uint64_t(1) << origin)) == 0 || (BBS::line_bb[origin][king_sq] & (uint64_t(1) << destination)) != 0;
 }
 
 
@@ -411,6 +558,42 @@ int GameState_t::piece_on(int sq, SIDE side) const {
 }
 
 
+/*
+
+Compute the position key after a move without making it. This only needs to be good enough to prefetch the transposition table bucket of the
+child position, so it ignores changes in castling rights, the castling rook and a new en-passant square. For all other moves it is exact.
+
+*/
+
+uint64_t GameState_t::key_after(unsigned int move) const {
+	SIDE Them = (side_to_move == WHITE) ? BLACK : WHITE;
+
+	int origin = FROMSQ(move);
+	int destination = TOSQ(move);
+	int piece_moved = piece_list[side_to_move][origin];
+	int piece_captured = piece_list[Them][destination];
+	int piece_placed = (SPECIAL(move) == PROMOTION) ? decode_promo[PROMTO(move)] : piece_moved;
+
+	uint64_t key = posKey ^ BBS::Zobrist::side_key;
+
+	// An existing en-passant square is always removed.
+	key ^= (enPasSq == NO_SQ) ? 0 : BBS::Zobrist::empty_keys[enPasSq];
+
+	key ^= BBS::Zobrist::piece_keys[side_to_move][piece_moved][origin];
+	key ^= BBS::Zobrist::piece_keys[side_to_move][piece_placed][destination];
+
+	if (piece_captured != NO_TYPE) {
+		key ^= BBS::Zobrist::piece_keys[Them][piece_captured][destination];
+	}
+	else if (SPECIAL(move) == ENPASSANT) {
+		key ^= BBS::Zobrist::piece_keys[Them][PAWN][(side_to_move == WHITE) ? (destination - 8) : (destination + 8)];
+	}
+
+	return key;
+}
+
+
+
 /*
 
 Function for making a move.
@@ -439,13 +622,15 @@ bool GameState_t::make_move(Move_t* move) {
 	assert(piece_moved >= PAWN && piece_moved < NO_TYPE);
 	assert(piece_captured >= PAWN && piece_captured <= NO_TYPE);
 
-	// Step 2. Check if the piece_captured is a king, and return false if it is.
-	if (piece_captured == KING) {
+	// Step 2. Check if the piece_captured is a king, or the move would leave our king in check, and return false if it is. Since this is found
+	//	without making the move, illegal moves are almost free.
+	if (piece_captured == KING || !is_legal(move->move)) {
 		return false;
 	}
 
 	// Step 3. Copy irreversible information about the position and save it.
 	SavedInfo_t* info = &history[history_ply];
+	NNUE::Delta delta; // The pieces added and removed by the move, for updating the NNUE accumulators.
 
 	info->move = move->move;
 	info->piece_captured = piece_captured;
@@ -454,6 +639,12 @@ bool GameState_t::make_move(Move_t* move) {
 	info->fifty_moves = fiftyMove;
 	info->enPasSq = enPasSq;
 	info->posKey = posKey;
+	info->pawnKey = pawnKey;
+	info->materialKey = materialKey;
+	info->psq_score = psq_score;
+	info->phase = phase;
+	info->checkers = checkers;
+	info->pinned = pinned;
 	history_ply++;
 
 	posKey ^= BBS::Zobrist::castling_keys[castleRights];
@@ -466,6 +657,17 @@ bool GameState_t::make_move(Move_t* move) {
 	piece_list[side_to_move][origin] = NO_TYPE;
 
 	posKey ^= BBS::Zobrist::piece_keys[side_to_move][piece_moved][origin];
+	psq_score -= PSQT::psq[side_to_move][piece_moved][origin];
+	delta.remove(side_to_move, piece_moved, origin);
+
+	// The pawn key only changes if a pawn moves or is captured (including promotions and en-passant).
+	if (piece_moved == PAWN) {
+		pawnKey ^= BBS::Zobrist::piece_keys[side_to_move][PAWN][origin];
+
+		if (spc != PROMOTION) {
+			pawnKey ^= BBS::Zobrist::piece_keys[side_to_move][PAWN][destination];
+		}
+	}
 
 
 	if (spc == PROMOTION) { // For promotions, another piece type should be placed on destination.
@@ -473,12 +675,21 @@ bool GameState_t::make_move(Move_t* move) {
 		piece_list[side_to_move][destination] = promotion_piece;
 
 		posKey ^= BBS::Zobrist::piece_keys[side_to_move][promotion_piece][destination];
+		psq_score += PSQT::psq[side_to_move][promotion_piece][destination];
+		delta.add(side_to_move, promotion_piece, destination);
+		phase += phase_values[promotion_piece];
+
+		// We have lost a pawn and gained a piece.
+		materialKey ^= BBS::Zobrist::piece_keys[side_to_move][PAWN][countBits(pieceBBS[PAWN][side_to_move])];
+		materialKey ^= BBS::Zobrist::piece_keys[side_to_move][promotion_piece][countBits(pieceBBS[promotion_piece][side_to_move]) - 1];
 	}
 	else {
 		pieceBBS[piece_moved][side_to_move] |= (uint64_t(1) << destination);
 		piece_list[side_to_move][destination] = piece_moved;
 
 		posKey ^= BBS::Zobrist::piece_keys[side_to_move][piece_moved][destination];
+		psq_score += PSQT::psq[side_to_move][piece_moved][destination];
+		delta.add(side_to_move, piece_moved, destination);
 	}
 
 
@@ -489,6 +700,15 @@ bool GameState_t::make_move(Move_t* move) {
 		piece_list[Them][destination] = NO_TYPE;
 
 		posKey ^= BBS::Zobrist::piece_keys[Them][piece_captured][destination];
+		psq_score -= PSQT::psq[Them][piece_captured][destination];
+		delta.remove(Them, piece_captured, destination);
+		phase -= phase_values[piece_captured];
+
+		if (piece_captured == PAWN) {
+			pawnKey ^= BBS::Zobrist::piece_keys[Them][PAWN][destination];
+		}
+
+		materialKey ^= BBS::Zobrist::piece_keys[Them][piece_captured][countBits(pieceBBS[piece_captured][Them])];
 	}
 
 	// Step 6. If the move is a castling move, move the rook.
@@ -501,11 +721,15 @@ bool GameState_t::make_move(Move_t* move) {
 			pieceBBS[ROOK][side_to_move] ^= (uint64_t(1) << ((side_to_move == WHITE) ? H1 : H8));
 			piece_list[side_to_move][(side_to_move == WHITE) ? H1 : H8] = NO_TYPE;
 			posKey ^= BBS::Zobrist::piece_keys[side_to_move][ROOK][(side_to_move == WHITE) ? H1 : H8];
+			psq_score -= PSQT::psq[side_to_move][ROOK][(side_to_move == WHITE) ? H1 : H8];
+			delta.remove(side_to_move, ROOK, (side_to_move == WHITE) ? H1 : H8);
 
 			// Then place the rook on f1 for white or f8 for black
 			pieceBBS[ROOK][side_to_move] |= (uint64_t(1) << ((side_to_move == WHITE) ? F1 : F8));
 			piece_list[side_to_move][(side_to_move == WHITE) ? F1 : F8] = ROOK;
 			posKey ^= BBS::Zobrist::piece_keys[side_to_move][ROOK][(side_to_move == WHITE) ? F1 : F8];
+			psq_score += PSQT::psq[side_to_move][ROOK][(side_to_move == WHITE) ? F1 : F8];
+			delta.add(side_to_move, ROOK, (side_to_move == WHITE) ? F1 : F8);
 		}
 		else {
 			assert((side_to_move == WHITE) ? can_castle<WQCA>() : can_castle<BQCA>());
@@ -513,11 +737,15 @@ bool GameState_t::make_move(Move_t* move) {
 			pieceBBS[ROOK][side_to_move] ^= (uint64_t(1) << ((side_to_move == WHITE) ? A1 : A8));
 			piece_list[side_to_move][(side_to_move == WHITE) ? A1 : A8] = NO_TYPE;
 			posKey ^= BBS::Zobrist::piece_keys[side_to_move][ROOK][(side_to_move == WHITE) ? A1 : A8];
+			psq_score -= PSQT::psq[side_to_move][ROOK][(side_to_move == WHITE) ? A1 : A8];
+			delta.remove(side_to_move, ROOK, (side_to_move == WHITE) ? A1 : A8);
 
 			// Then place the rook on d1 for white or d8 for black
 			pieceBBS[ROOK][side_to_move] |= (uint64_t(1) << ((side_to_move == WHITE) ? D1 : D8));
 			piece_list[side_to_move][(side_to_move == WHITE) ? D1 : D8] = ROOK;
 			posKey ^= BBS::Zobrist::piece_keys[side_to_move][ROOK][(side_to_move == WHITE) ? D1 : D8];
+			psq_score += PSQT::psq[side_to_move][ROOK][(side_to_move == WHITE) ? D1 : D8];
+			delta.add(side_to_move, ROOK, (side_to_move == WHITE) ? D1 : D8);
 		}
 	}
 
@@ -527,6 +755,10 @@ bool GameState_t::make_move(Move_t* move) {
 		piece_list[(side_to_move == WHITE) ? BLACK : WHITE][(side_to_move == WHITE) ? (destination - 8) : (destination + 8)] = NO_TYPE;
 
 		posKey ^= BBS::Zobrist::piece_keys[Them][PAWN][(side_to_move == WHITE) ? (destination - 8) : (destination + 8)];
+		pawnKey ^= BBS::Zobrist::piece_keys[Them][PAWN][(side_to_move == WHITE) ? (destination - 8) : (destination + 8)];
+		psq_score -= PSQT::psq[Them][PAWN][(side_to_move == WHITE) ? (destination - 8) : (destination + 8)];
+		delta.remove(Them, PAWN, (side_to_move == WHITE) ? (destination - 8) : (destination + 8));
+		materialKey ^= BBS::Zobrist::piece_keys[Them][PAWN][countBits(pieceBBS[PAWN][Them])];
 	}
 
 	// Step 8. Update the castling rights --> if the king has been moved, all castling rights for that side will be removed. If a piece has moved to or from
@@ -596,14 +828,15 @@ bool GameState_t::make_move(Move_t* move) {
 	posKey ^= BBS::Zobrist::castling_keys[castleRights];
 	posKey ^= BBS::Zobrist::side_key;
 
-	// Step 13. See if the king is in check. If it is, then undo the move and return false.
-	if (square_attacked(king_squares[side_to_move], (side_to_move == WHITE) ? BLACK : WHITE)) {
-		side_to_move = (side_to_move == WHITE) ? BLACK : WHITE; // undo_move will toggle this, so we have to change it before calling the function.
-		undo_move();
-		return false;
-	}
-
+	// Step 13. Change the side to move, and find the checkers and pinned pieces for it.
 	side_to_move = (side_to_move == WHITE) ? BLACK : WHITE;
+	update_check_info();
+
+	// Step 14. Update the NNUE accumulators.
+	if (NNUE::active) {
+		ensure_accumulators();
+		NNUE::update(accumulators[history_ply], accumulators[history_ply - 1], delta);
+	}
 
 	return true;
 }
@@ -737,6 +970,14 @@ void GameState_t::undo_move() {
 
 	fiftyMove = info->fifty_moves;
 
+	// The pawn key is just restored instead of being updated incrementally.
+	pawnKey = info->pawnKey;
+	materialKey = info->materialKey;
+	psq_score = info->psq_score;
+	phase = info->phase;
+	checkers = info->checkers;
+	pinned = info->pinned;
+
 	// Step 10. Decrement the ply and history ply.
 	ply--;
 	history_ply--;
@@ -758,8 +999,9 @@ int GameState_t::make_nullmove() {
 	// Step 2. Toggle side to move in the hashkey
 	posKey ^= BBS::Zobrist::side_key;
 
-	// Step 3. Increment ply
+	// Step 3. Increment ply and find the pinned pieces of the new side to move. It can't be in check, since we don't make null moves when in check.
 	ply += 1;
+	update_check_info();
 
 	// Step 4. If there is an en-passant square, return the index and remove it.
 	if (enPasSq != NO_SQ) {
@@ -798,6 +1040,7 @@ void GameState_t::undo_nullmove(int oldEnPas) {
 
 	// Step 4. Change side to move.
 	side_to_move = (side_to_move == WHITE) ? BLACK : WHITE;
+	update_check_info();
 }
 
 
@@ -847,12 +1090,28 @@ GameState_t::GameState_t() {
 
 /*
 
-Copy constructor of the GameState_t class (Usage: GameState_t newG = pos)
+Copy constructor of the GameState_t class (Usage: GameState_t newG = pos). It is implemented by the copy assignment below.
 
 */
 
 
 GameState_t::GameState_t(const GameState_t& pos) {
+	*this = pos;
+}
+
+
+/*
+
+Copy assignment of the GameState_t class (Usage: newG = pos). Like the copy constructor, only the live part of the NNUE accumulators is copied.
+
+*/
+
+
+GameState_t& GameState_t::operator=(const GameState_t& pos) {
+	if (this == &pos) {
+		return *this;
+	}
+
 
 	// Copy piece bitboards
 	pieceBBS[PAWN][WHITE]	= pos.pieceBBS[PAWN][WHITE];
@@ -885,18 +1144,37 @@ GameState_t::GameState_t(const GameState_t& pos) {
 	king_squares[WHITE] = pos.king_squares[WHITE];
 	king_squares[BLACK] = pos.king_squares[BLACK];
 
+	checkers = pos.checkers;
+	pinned = pos.pinned;
+
 	// Copy en-passant square, castling rights, ply and fifty move counter
 	enPasSq = pos.enPasSq;
 	castleRights = pos.castleRights;
 	ply = pos.ply;
 	fiftyMove = pos.fiftyMove;
 
-	// Copy zobrist hashkey
+	// Copy zobrist hashkeys
 	posKey = pos.posKey;
+	pawnKey = pos.pawnKey;
+	materialKey = pos.materialKey;
+
+	psq_score = pos.psq_score;
+	phase = pos.phase;
 
 	// Copy history and history ply
 	std::copy(std::begin(pos.history), std::end(pos.history), std::begin(history));
 	history_ply = pos.history_ply;
+
+	// Copy the NNUE accumulators of the current position and the ones before it. If the position never had a network active, it has none.
+	if (pos.accumulators.empty()) {
+		accumulators.clear();
+	}
+	else {
+		ensure_accumulators();
+		std::copy(pos.accumulators.begin(), pos.accumulators.begin() + history_ply + 1, accumulators.begin());
+	}
+
+	return *this;
 }
 
 
@@ -925,6 +1203,11 @@ bool GameState_t::insufficient_material() const {
 
 	int num_pieces_total = countBits(all_pieces[WHITE] | all_pieces[BLACK]);
 
+	// None of the drawn configurations below have more than four pieces, so most positions can be dismissed right away.
+	if (num_pieces_total > 4) {
+		return false;
+	}
+
 	// Lone king against a king and a minor is an immediate draw. This is true if there are three pieces and either side has a bishop or a knight
 	if (num_pieces_total == 3 
 		&& countBits(pieceBBS[KNIGHT][WHITE] | pieceBBS[BISHOP][WHITE] | pieceBBS[KNIGHT][BLACK] | pieceBBS[BISHOP][BLACK]) > 0) {
@@ -1004,6 +1287,7 @@ void GameState_t::mirror_board() {
 	enPasSq = tempEnPas;
 
 	generate_poskey();
+	generate_psq();
 
 	all_pieces[WHITE] = (pieceBBS[PAWN][WHITE] | pieceBBS[KNIGHT][WHITE] | pieceBBS[BISHOP][WHITE] |
 		pieceBBS[ROOK][WHITE] | pieceBBS[QUEEN][WHITE] | pieceBBS[KING][WHITE]);
@@ -1013,6 +1297,8 @@ void GameState_t::mirror_board() {
 	king_squares[WHITE] = bitScanForward(pieceBBS[KING][WHITE]);
 	king_squares[BLACK] = bitScanForward(pieceBBS[KING][BLACK]);
 
+	update_check_info();
+
 	assert(lists_match());
 }
 
@@ -1042,9 +1328,20 @@ bool GameState_t::is_ok() {
 
 	// Se if the incrementally updated zobrist key matches the real one for the position.
 	uint64_t old_poskey = posKey;
+	uint64_t old_pawnkey = pawnKey;
+	uint64_t old_materialkey = materialKey;
 	generate_poskey();
 
-	if (posKey != old_poskey) {
+	if (posKey != old_poskey || pawnKey != old_pawnkey || materialKey != old_materialkey) {
+		return false;
+	}
+
+	// Same for the material and piece-square table score.
+	Score old_psq = psq_score;
+	int old_phase = phase;
+	generate_psq();
+
+	if (psq_score != old_psq || phase != old_phase) {
 		return false;
 	}
 
@@ -21,6 +21,9 @@
 
 #include "bitboard.h"
 #include "move.h"
+#include "nnue.h"
+
+#include <vector>
 
 #if !defined(_MSC_VER)
 #include <cstring> // To use strcpy with GCC
@@ -39,9 +42,30 @@ public:
 	int enPasSq = 0;
 
 	uint64_t posKey = 0;
+	uint64_t pawnKey = 0;
+	uint64_t materialKey = 0;
+
+	Score psq_score;
+	int phase = 0;
+
+	Bitboard checkers = 0;
+	Bitboard pinned = 0;
 };
 
 
+/*
+Material and piece-square values used for the incrementally updated score of GameState_t (defined in psqt.cpp)
+*/
+namespace PSQT {
+	// The material value plus the piece-square table value of a piece on a square as a packed score. The values for black are negated such that
+	// the sum over all pieces is from white's point of view. Indexed by psq[side][piecetype][square].
+	extern Score psq[2][6][64];
+}
+
+// The contribution of each piece type to the game phase. The starting position has a phase of 24.
+constexpr int phase_values[6] = { 0, 1, 1, 2, 4, 0 };
+
+
 class GameState_t {
 public:
 	// Indexed by pieceBBS[pieceType][Color]
@@ -59,6 +83,11 @@ public:
 	// King squares. Indexed by king_squares[side]
 	int king_squares[2] = { 0 };
 
+	// The enemy pieces giving check to the side to move, and the pieces of the side to move that are pinned to its king. They are updated every
+	//	time the side to move changes, such that moves can be tested for legality without making them.
+	Bitboard checkers = 0;
+	Bitboard pinned = 0;
+
 	int enPasSq = NO_SQ;
 
 	int castleRights = 0;
@@ -75,11 +104,29 @@ public:
 	volatile Bitboard posKey = 0;
 	void generate_poskey();
 
+	// A zobrist hash of the pawns only. Used to index the pawn hash table in the evaluation.
+	uint64_t pawnKey = 0;
+
+	// A zobrist hash of the number of each piece type for both sides. Used to index the material hash table in the evaluation.
+	uint64_t materialKey = 0;
+
+	// The material and piece-square table score from white's point of view as a packed Score, and the game phase counter.
+	// They are updated incrementally such that the evaluation doesn't have to loop over the pieces.
+	Score psq_score;
+	int phase = 0;
+	void generate_psq();
+
+	// Evaluate the position with the neural network. Only valid if NNUE::active.
+	int nnue_evaluate() const;
+
 
 	// For making moves on the board.
 	bool make_move(Move_t* move);
 	void undo_move();
 
+	// Returns an approximation of the position key after a move, without making it. Used for prefetching the transposition table.
+	uint64_t key_after(unsigned int move) const;
+
 	// For null move pruning
 	int make_nullmove();
 	void undo_nullmove(int oldEnPas);
@@ -93,10 +140,17 @@ public:
 	// Returns true if the side to move is in check
 	bool in_check() const;
 
+	// Returns true if a pseudo-legal move doesn't leave the king of the side to move in check.
+	bool is_legal(unsigned int move) const;
+
 	// Returns a bitboard with all the pieces pinned to the king of side S
 	template<SIDE S>
 	Bitboard pinned_pieces() const;
 
+	// Returns a bitboard with all the pieces of side S that give a discovered check when they move off the line to the enemy king
+	template<SIDE S>
+	Bitboard discovered_check_candidates() const;
+
 	// Returns true if there are no sliding pieces for the side to move. Used for null move pruning
 	bool safe_nullmove() const;
 
@@ -110,6 +164,9 @@ public:
 	// Returns true if we are repeating moves or have reached the fifty-move rule limit.
 	bool is_draw() const;
 
+	// Returns true if the material situation on the board is such that none of the sides can possibly checkmate the other.
+	bool insufficient_material() const;
+
 	/*
 	SEE functions - the SEE algorithm itself will be implemented later
 	*/
@@ -146,8 +203,9 @@ public:
 	Constructors
 	*/
 
-	// Copy constructor
+	// Copy constructor and assignment. These only copy the NNUE accumulators that belong to the position and the ones before it.
 	GameState_t(const GameState_t& pos);
+	GameState_t& operator=(const GameState_t& pos);
 
 	// Default constructor. Is just zero since everything is initialized already.
 	GameState_t();
@@ -159,12 +217,27 @@ private:
 	// Returns true if the position has been had before.
 	bool is_repetition() const;
 
-	// Returns true if the material situation on the board is such that none of the sides can possibly checkmate the other.
-	bool insufficient_material() const;
+	// Compute checkers and pinned for the side to move.
+	void update_check_info();
+
+	// Returns the pieces of one side attacking a square, given the occupancy of the board.
+	Bitboard attackers_of(int sq, SIDE side, Bitboard occupied) const;
 
 	// Array for all SavedInfo_t after each move. Declared on heap because it might take too much stack when having multiple GameState_t for multithreading.
 	SavedInfo_t history[MAXGAMEMOVES] = {  };
 	int history_ply = 0; // Amount of SaveInfo_t in history.	
+
+	// The NNUE accumulators, indexed like history such that accumulators[history_ply] belongs to the current position. They are computed
+	//	lazily when the position is evaluated, so they are mutable. Since they take up more than a megabyte, they are only allocated once a
+	//	network is active.
+	mutable std::vector<NNUE::Accumulator> accumulators;
+
+	// Allocate the accumulators if it hasn't been done yet. The new ones don't belong to any network generation, so they'll be refreshed.
+	void ensure_accumulators() const {
+		if (accumulators.empty()) {
+			accumulators.resize(MAXGAMEMOVES + 1);
+		}
+	}
 };
 
 
@@ -181,54 +254,52 @@ template<SIDE S>
 Bitboard GameState_t::pinned_pieces() const {
 	constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
 	int king_square = king_squares[S];
+	Bitboard occupied = all_pieces[WHITE] | all_pieces[BLACK];
 
-	Bitboard pinned = 0;
+	Bitboard pinned_bb = 0;
 
-	// We need to generate the queen attacks (as if the board was cleared for all pieces) from the king square. We do this with our magic bitboards
-	Bitboard king_rays = Magics::attacks_bb<QUEEN>(king_square, 0);
-	Bitboard king_attacks = Magics::attacks_bb<QUEEN>(king_square, all_pieces[WHITE] | all_pieces[BLACK]);
+	// The enemy sliders that would attack the king on an empty board pin a piece if it is the only one between them and the king.
+	Bitboard snipers = ((pieceBBS[BISHOP][Them] | pieceBBS[QUEEN][Them]) & Magics::attacks_bb<BISHOP>(king_square, 0))
+		| ((pieceBBS[ROOK][Them] | pieceBBS[QUEEN][Them]) & Magics::attacks_bb<ROOK>(king_square, 0));
 
-	// Firstly, we'll check for bishops or queens on the diagonals
-	Bitboard queen_bishop_attackers = (pieceBBS[BISHOP][Them] | pieceBBS[QUEEN][Them]) &
-		(king_rays & (BBS::diagonalMasks[7 + (king_square / 8) - (king_square % 8)] | BBS::antidiagonalMasks[(king_square / 8) + (king_square % 8)]));
+	while (snipers) {
+		Bitboard blockers = BBS::between_bb[king_square][PopBit(&snipers)] & occupied;
 
-	int sq = NO_SQ;
-	Bitboard attacks = 0;
-	Bitboard blockers = 0;
-	while (queen_bishop_attackers) {
-		sq = PopBit(&queen_bishop_attackers); // Get the position of the attacking piece
-		attacks = Magics::attacks_bb<BISHOP>(sq, all_pieces[WHITE] | all_pieces[BLACK]);
+		if (blockers != 0 && (blockers & (blockers - 1)) == 0) {
+			pinned_bb |= blockers & all_pieces[S];
+		}
+	}
 
-		blockers = (attacks & king_attacks);
-		blockers &= (BBS::diagonalMasks[7 + (king_square / 8) - (king_square % 8)] | BBS::antidiagonalMasks[(king_square / 8) + (king_square % 8)]);
-		blockers &= all_pieces[S];
+	return pinned_bb;
+}
 
-		if (blockers) {
-			assert(countBits(blockers) == 1);
 
-			pinned |= (uint64_t(1) << bitScanForward(blockers));
-		}
-	}
+/*
+Discovered check candidates --> Gets all pieces of color S that are the only piece between one of our sliders and the enemy king.
+NOTE: This function is in the header due to the template.
+*/
 
-	// Now we'll get the attacks on files/ranks from rooks and queens
-	Bitboard queen_rook_attackers = (pieceBBS[ROOK][Them] | pieceBBS[QUEEN][Them]) &
-		(king_rays & (BBS::FileMasks8[king_square % 8] | BBS::RankMasks8[king_square / 8]));
+template<SIDE S>
+Bitboard GameState_t::discovered_check_candidates() const {
+	constexpr SIDE Them = (S == WHITE) ? BLACK : WHITE;
+	int king_square = king_squares[Them];
+	Bitboard occupied = all_pieces[WHITE] | all_pieces[BLACK];
 
-	while (queen_rook_attackers) {
-		sq = PopBit(&queen_rook_attackers);
-		attacks = Magics::attacks_bb<ROOK>(sq, all_pieces[WHITE] | all_pieces[BLACK]);
+	Bitboard candidates = 0;
 
-		blockers = (attacks & king_attacks) & (BBS::FileMasks8[king_square % 8] | BBS::RankMasks8[king_square / 8]);
-		blockers &= all_pieces[S];
+	// This is the same as finding pinned pieces, but with our own sliders pointing at the enemy king through our own pieces.
+	Bitboard snipers = ((pieceBBS[BISHOP][S] | pieceBBS[QUEEN][S]) & Magics::attacks_bb<BISHOP>(king_square, 0))
+		| ((pieceBBS[ROOK][S] | pieceBBS[QUEEN][S]) & Magics::attacks_bb<ROOK>(king_square, 0));
 
-		if (blockers) {
-			assert(countBits(blockers) == 1);
+	while (snipers) {
+		Bitboard blockers = BBS::between_bb[king_square][PopBit(&snipers)] & occupied;
 
-			pinned |= (uint64_t(1) << bitScanForward(blockers));
+		if (blockers != 0 && (blockers & (blockers - 1)) == 0) {
+			candidates |= blockers & all_pieces[S];
 		}
 	}
 
-	return pinned;
+	return candidates;
 }
 
 
@@ -150,10 +150,28 @@ namespace PSQT {
 		}
 	}
 
+	Score psq[2][6][64];
+
+	/// <summary>
+	/// Initialize the combined material and piece-square table values used for the incrementally updated score of GameState_t.
+	/// </summary>
+	void initPsq() {
+		const Score* tables[6] = { &PawnTable[0], &KnightTable[0], &BishopTable[0], &RookTable[0], &QueenTable[0], &KingTable[0] };
+		const Score values[6] = { pawn_value, knight_value, bishop_value, rook_value, queen_value, Score(0, 0) };
+
+		for (int pce = PAWN; pce <= KING; pce++) {
+			for (int sq = 0; sq < 64; sq++) {
+				psq[WHITE][pce][sq] = values[pce] + tables[pce][sq];
+				psq[BLACK][pce][sq] = -(values[pce] + tables[pce][Mirror64[sq]]);
+			}
+		}
+	}
+
 	/// <summary>
-	/// Initialize the psqt's. For now, it's only the Manhattan-Distance table.
+	/// Initialize the psqt's. This is the Manhattan-Distance table and the combined material and piece-square tables.
 	/// </summary>
 	void INIT() {
 		initManhattanDistance();
+		initPsq();
 	}
 }
\ No newline at end of file
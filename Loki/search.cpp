@@ -25,6 +25,10 @@ ThreadPool_t* Search::threads = nullptr;
 std::vector<std::thread> Search::threads_running;
 std::atomic<bool> Search::isStop(true);
 
+// The threads of the last search. They are kept until the number of threads changes or reset_threads is called, such that their evaluation, pawn
+//	and material tables aren't reallocated for every search.
+static ThreadPool_t* thread_pool = nullptr;
+
 
 // The checkup function sees if we need to stop the search
 void check_stopped_search(SearchThread_t* ss) {
@@ -123,6 +127,14 @@ void lmr_conditions(const SearchThread_t* ss, bool improving, bool capture, bool
 	R -= gives_check;
 	R -= promotes;
 
+	// Step 7. Decrease reduction for quiet moves that take a threatened piece to a square not attacked by enemy pawns.
+	const Eval::Threats_t& threats = ss->stats.threats[ss->pos->ply - 1];
+
+	if (!capture && threats.valid && (threats.en_prise() & (uint64_t(1) << fromSq))
+		&& !(threats.pawn_attacked & (uint64_t(1) << toSq))) {
+		R -= 1;
+	}
+
 }
 
 
@@ -145,7 +157,7 @@ bool is_passed(int fromSq, GameState_t* pos) {
 
 // The razoring margin should rise with depth, and on top of that, we do not want to prune too aggresively if our eval is improving
 int razoring_margin(int depth, bool i) {
-	return (2 * pawn_value.mg + (depth - 1) * (pawn_value.mg / 2)) + ((i == true) ? 100 : 0);
+	return (2 * pawn_value.mg() + (depth - 1) * (pawn_value.mg() / 2)) + ((i == true) ? 100 : 0);
 }
 
 
@@ -159,36 +171,45 @@ namespace Search {
 			num_threads = 1;
 		}
 
-		// Increment transposition table age
+		// Make sure a background resize or clear of the transposition table has finished, and increment its age.
+		tt->wait();
 		tt->increment_age();
 
+		if (qtt != nullptr) {
+			qtt->wait();
+			qtt->increment_age();
+		}
+
 		threads_running.clear();
 
-		ThreadPool_t tp(num_threads);
-		threads = &tp;
+		if (thread_pool == nullptr || thread_pool->count() != num_threads) {
+			reset_threads();
+			thread_pool = new ThreadPool_t(num_threads);
+		}
+
+		threads = thread_pool;
 		threads->init_threads(pos, info);
 
 		// The "accumulated" depth gets incremented for all threads that have an odd thread_id and are not the 0'th
 		int acc_depth = info->depth;
-		if (num_threads > 1) {
-
-			for (int t = 0; t < threads->count(); t++){
-				// Lazy SMP depth variation
-				if (t != 0 && t % 2 != 0) {
-					acc_depth++;
-					(threads->at(t))->info->depth = acc_depth;
-				}
-
-				threads_running.push_back(std::thread(searchPosition, threads->at(t)));
+		for (int t = 0; t < threads->count(); t++){
+			// Lazy SMP depth variation
+			if (t != 0 && t % 2 != 0) {
+				acc_depth++;
+				(threads->at(t))->info->depth = acc_depth;
 			}
 
-			// Wait for all threads to finish
-			for (int t = 0; t < threads->count(); t++) {
-				threads_running[t].join();
-			}
+			// If NUMA support is enabled, bind the thread to the node its SearchThread_t was allocated on (see ThreadPool_t), such that its
+			//	tables are local. This is also done with a single thread, so that one isn't left to run on whichever node the UCI thread is on.
+			threads_running.push_back(std::thread([t]() {
+				Numa::bind_thread(t);
+				searchPosition(threads->at(t));
+			}));
 		}
-		else {
-			searchPosition(threads->at(0));
+
+		// Wait for all threads to finish
+		for (int t = 0; t < threads->count(); t++) {
+			threads_running[t].join();
 		}
 
 		
@@ -199,12 +220,24 @@ namespace Search {
 
 		// We save the node-count of the main thread to be used by the benchmarking method
 		info->nodes = (threads->at(0))->info->nodes;
+		info->tt_stats = getTTStats();
+		info->eval_stats = getEvalStats();
 
 		isStop = true;
 		threads = nullptr;
 	}
 
 
+	/// <summary>
+	/// Delete the threads kept from the last search. The next search will allocate new ones, which picks up changes to the evaluation hash table
+	///	options and the NUMA setting.
+	/// </summary>
+	void reset_threads() {
+		delete thread_pool;
+		thread_pool = nullptr;
+	}
+
+
 	void searchPosition(SearchThread_t* ss) {
 		// Clear ss before searching
 		clearForSearch(ss);
@@ -279,6 +312,7 @@ namespace Search {
 					<< " seldepth " << ss->info->seldepth
 					<< " nodes " << nodes
 					<< " nps " << nps
+					<< " hashfull " << tt->hashfull()
 					<< " time " << time_to_depth;
 				
 				std::cout << " pv ";
@@ -318,6 +352,21 @@ namespace Search {
 
 		if (ss->thread_id == 0) {
 
+			// Report the transposition table counters of all threads.
+			TT_Stats tt_stats = getTTStats();
+			std::cout << "info string tt probes " << tt_stats.probes
+				<< " hits " << tt_stats.hits
+				<< " cutoffs " << tt_stats.cutoffs
+				<< " occupied_misses " << tt_stats.occupied_misses
+				<< " stores same " << tt_stats.stores_same
+				<< " skipped " << tt_stats.stores_skipped
+				<< " empty " << tt_stats.stores_empty
+				<< " replaced " << tt_stats.stores_replaced << std::endl;
+
+			EvalTable_Stats eval_stats = getEvalStats();
+			std::cout << "info string evalhash probes " << eval_stats.probes
+				<< " hits " << eval_stats.hits << std::endl;
+
 			std::cout << "bestmove " << printMove(best_move) << std::endl;
 			
 			// If the search stopped because the max depth has been reached, we need to stop all other threads.
@@ -339,6 +388,8 @@ namespace Search {
 		ss->info->fh = 0;
 		ss->info->fhf = 0;
 
+		ss->eval->clear_table_stats();
+
 		reductions = 0;
 		re_searches = 0;
 
@@ -454,8 +505,8 @@ namespace Search {
 		// Step 2. Probe transposition table --> If there is a move from previous iterations, we'll assume the best move from that as the best move now, and
 		//	order that first.
 		bool ttHit = false;
-		EntryData_t* entry = tt->probe_tt(ss->pos->posKey, ttHit);
-		unsigned int pvMove = (ttHit) ? entry->get_move() : NOMOVE;
+		EntryData_t entry = tt->probe_tt(ss->pos->posKey, ttHit, &ss->info->tt_stats);
+		unsigned int pvMove = (ttHit) ? entry.get_move() : NOMOVE;
 
 
 		if (ss->pos->ply >= ss->info->seldepth) {
@@ -467,7 +518,7 @@ namespace Search {
 		if (in_check) {
 			ss->stats.static_eval[ss->pos->ply] = VALUE_NONE;
 		}
-		ss->stats.static_eval[ss->pos->ply] = ss->eval->score(ss->pos);
+		ss->stats.static_eval[ss->pos->ply] = (ttHit && entry.get_eval() != VALUE_NONE) ? entry.get_eval() : ss->eval->score(ss->pos);
 
 
 		// Step 4. Initialize a staged move generation object and loop through all moves.
@@ -478,6 +529,9 @@ namespace Search {
 		while (stager.next_move(move)) {
 			line.clear();
 
+			// Start loading the child's transposition table bucket before making the move, like in alphabeta.
+			tt->prefetch(ss->pos->key_after(move.move));
+
 			if (!ss->pos->make_move(&move)) {
 				continue;
 			}
@@ -513,7 +567,7 @@ namespace Search {
 				}
 				ss->info->fh++;
 
-				tt->store_entry(ss->pos, move.move, beta, depth, ttFlag::BETA);
+				tt->store_entry(ss->pos, move.move, beta, ss->stats.static_eval[ss->pos->ply], depth, ttFlag::BETA, &ss->info->tt_stats);
 
 
 				return beta;
@@ -546,10 +600,10 @@ namespace Search {
 		if (raised_alpha) {
 			assert(best_move == pvLine->pv[0]);
 		
-			tt->store_entry(ss->pos, best_move, alpha, depth, ttFlag::EXACT);
+			tt->store_entry(ss->pos, best_move, alpha, ss->stats.static_eval[ss->pos->ply], depth, ttFlag::EXACT, &ss->info->tt_stats);
 		}
 		else {
-			tt->store_entry(ss->pos, best_move, alpha, depth, ttFlag::ALPHA);
+			tt->store_entry(ss->pos, best_move, alpha, ss->stats.static_eval[ss->pos->ply], depth, ttFlag::ALPHA, &ss->info->tt_stats);
 		}
 	
 		return alpha;
@@ -649,12 +703,12 @@ namespace Search {
 		// Step 4. Transposition table probing (~30 elo - too little?). This is done before quiescence since it is quite fast, and if we can get a cutoff before
 		// going into quiescence, we'll of course use that. Probing before quiescence search contributed with ~17 elo.
 		bool ttHit = false;
-		EntryData_t* entry = tt->probe_tt(ss->pos->posKey, ttHit);
+		EntryData_t entry = tt->probe_tt(ss->pos->posKey, ttHit, &ss->info->tt_stats);
 		
-		int ttScore = (ttHit) ? value_from_tt(entry->get_score(), ss->pos->ply) : -INF;
-		unsigned int ttMove = (ttHit) ? entry->get_move() : NOMOVE;
-		int ttDepth = (ttHit) ? entry->get_depth() : 0;
-		int tt_flag = (ttHit) ? entry->get_flag() : ttFlag::NO_FLAG;
+		int ttScore = (ttHit) ? value_from_tt(entry.get_score(), ss->pos->ply) : -INF;
+		unsigned int ttMove = (ttHit) ? entry.get_move() : NOMOVE;
+		int ttDepth = (ttHit) ? entry.get_depth() : 0;
+		int tt_flag = (ttHit) ? entry.get_flag() : ttFlag::NO_FLAG;
 		
 		// If we're not in a PV-node (beta - alpha == 1), we can do a cutoff if the transposition table returned a valid depth.
 		if (ttHit
@@ -662,14 +716,17 @@ namespace Search {
 			&& ttDepth >= depth) {
 		
 			if (tt_flag == BETA && ttScore >= beta) {
+				ss->info->tt_stats.cutoffs++;
 				return beta;
 			}
 		
 			else if (tt_flag == ALPHA && ttScore <= alpha) {
+				ss->info->tt_stats.cutoffs++;
 				return alpha;
 			}
 
 			else if (tt_flag == EXACT) {
+				ss->info->tt_stats.cutoffs++;
 				return ttScore;
 			}
 		}
@@ -680,12 +737,27 @@ namespace Search {
 		if (in_check) {
 			// If we're in check, we'll go directly to the moves since we don't want this branch pruned away.
 			ss->stats.static_eval[ss->pos->ply] = VALUE_NONE;
+			ss->stats.threats[ss->pos->ply].mark_unknown();
 			improving = false;
 		
 			goto moves_loop;
 		}
 		
-		ss->stats.static_eval[ss->pos->ply] = ss->eval->score(ss->pos);
+		// If the position was found in the transposition table, it also holds the static evaluation, so we don't need to compute it again.
+		if (ttHit && entry.get_eval() != VALUE_NONE) {
+			ss->stats.static_eval[ss->pos->ply] = entry.get_eval();
+			ss->stats.threats[ss->pos->ply].mark_unknown();
+		}
+		else {
+			ss->stats.static_eval[ss->pos->ply] = ss->eval->score(ss->pos);
+			ss->stats.threats[ss->pos->ply] = ss->eval->get_threats();
+		}
+
+		// The threats are only gathered by a full evaluation, so if the score came from a hash table, generate them on their own. Move ordering,
+		//	LMR and reverse futility pruning all use them.
+		if (!ss->stats.threats[ss->pos->ply].valid) {
+			ss->stats.threats[ss->pos->ply] = Eval::compute_threats(ss->pos);
+		}
 		//improving = (ss->pos->ply >= 2) ?
 		//	(ss->stats.static_eval[ss->pos->ply] >= ss->stats.static_eval[ss->pos->ply - 2] || ss->stats.static_eval[ss->pos->ply - 2] == VALUE_NONE) :
 		//	false;
@@ -761,8 +833,11 @@ namespace Search {
 		
 		
 		// Step 8. Reverse futility pruning (~30 elo). If our static evaluation beats beta by the futility margin, we can most likely just return beta.
+		//	This isn't the case if the opponent threatens to win one of our pieces, since the static evaluation doesn't see that, so we only prune
+		//	if the threats are known.
 		if (depth < 7 && !in_check && !is_pv
-			&& abs(alpha) < MATE && abs(beta) < MATE) {
+			&& abs(alpha) < MATE && abs(beta) < MATE
+			&& ss->stats.threats[ss->pos->ply].valid && !ss->stats.threats[ss->pos->ply].en_prise()) {
 		
 			int margin = 175 * depth - ((improving) ? 75 : 0);
 			
@@ -819,7 +894,7 @@ namespace Search {
 		//	//}
 		//
 		//	// Step 11B. Probe the transposition table to see if we have found a (probably) best move.
-		//	entry = tt->probe_tt(ss->pos->posKey, ttHit);
+		//	entry = tt->probe_tt(ss->pos->posKey, ttHit, &ss->info->tt_stats);
 		//
 		//	int ttScore = (ttHit) ? value_from_tt(entry->score, ss->pos->ply) : -INF;
 		//	unsigned int ttMove = (ttHit) ? entry->move : NOMOVE;
@@ -849,7 +924,9 @@ namespace Search {
 				extensions++;
 			}
 
-			// Make the move.
+			// Make the move. We'll start loading the child's transposition table bucket first, such that it is (hopefully) in cache when we probe it.
+			tt->prefetch(ss->pos->key_after(current_move.move));
+
 			if (!ss->pos->make_move(&current_move)) {
 				continue;
 			}
@@ -946,7 +1023,7 @@ namespace Search {
 				}
 				
 				
-				tt->store_entry(ss->pos, move, beta, depth, ttFlag::BETA);
+				tt->store_entry(ss->pos, move, beta, ss->stats.static_eval[ss->pos->ply], depth, ttFlag::BETA, &ss->info->tt_stats);
 
 				return beta;
 			}
@@ -977,11 +1054,11 @@ namespace Search {
 
 		
 		if (alpha > old_alpha) {
-			tt->store_entry(ss->pos, best_move, alpha, depth, ttFlag::EXACT);
+			tt->store_entry(ss->pos, best_move, alpha, ss->stats.static_eval[ss->pos->ply], depth, ttFlag::EXACT, &ss->info->tt_stats);
 
 		}
 		else{
-			tt->store_entry(ss->pos, best_move, alpha, depth, ttFlag::ALPHA);
+			tt->store_entry(ss->pos, best_move, alpha, ss->stats.static_eval[ss->pos->ply], depth, ttFlag::ALPHA, &ss->info->tt_stats);
 		}
 
 
@@ -991,7 +1068,7 @@ namespace Search {
 
 	const int delta_piece_value[5] = { 100, 310, 350, 560, 1000 };
 
-	int quiescence(SearchThread_t* ss, int alpha, int beta) {
+	int quiescence(SearchThread_t* ss, int alpha, int beta, int depth) {
 		assert(beta > alpha);
 		
 		ss->info->nodes++;
@@ -1013,37 +1090,66 @@ namespace Search {
 			return ss->eval->score(ss->pos);
 		}
 
-		// Step 2. Static evaluation and possible cutoff if this beats beta.
-		int stand_pat = ss->eval->score(ss->pos);
+		// Step 2. Probe the quiescence table (if it is enabled). Only the first ply searches quiet checks, so its entries are stored with depth 0
+		//	and the ones below it with depth -1. An entry gives a cutoff if it has searched at least the moves this node would, and otherwise we
+		//	can still use its move for ordering and its static evaluation.
+		int qdepth = (use_qsearch_checks && depth >= 0) ? 0 : -1;
+		bool ttHit = false;
+		EntryData_t entry;
+		if (qtt != nullptr) {
+			entry = qtt->probe_tt(ss->pos->posKey, ttHit);
+		}
+
+		if (ttHit && entry.get_depth() >= qdepth) {
+			int ttScore = value_from_tt(entry.get_score(), ss->pos->ply);
+
+			if ((entry.get_flag() == BETA && ttScore >= beta) || (entry.get_flag() == ALPHA && ttScore <= alpha)) {
+				return (entry.get_flag() == BETA) ? beta : alpha;
+			}
+			else if (entry.get_flag() == EXACT) {
+				return ttScore;
+			}
+		}
+
+		// Step 3. Static evaluation and possible cutoff if this beats beta. The evaluation is allowed to be lazy, since we only need to know how it
+		//	compares to alpha and beta. A lazy evaluation isn't the real one though, so it isn't stored in the quiescence table.
+		bool lazy_eval = false;
+		int stand_pat = (ttHit && entry.get_eval() != VALUE_NONE) ? entry.get_eval() : ss->eval->score(ss->pos, alpha, beta, lazy_eval);
+		int static_eval = lazy_eval ? VALUE_NONE : stand_pat;
 
 		assert(stand_pat > -MATE && stand_pat < MATE);
 
-		if (stand_pat >= beta) {
+		// If we're in check, we can't stand pat, since the position might be lost. Instead, all evasions are searched.
+		bool in_check = ss->pos->in_check();
+
+		if (stand_pat >= beta && !in_check) {
+			if (qtt != nullptr) {
+				qtt->store_entry(ss->pos, NOMOVE, value_to_tt(stand_pat, ss->pos->ply), static_eval, qdepth, ttFlag::BETA);
+			}
 			return beta;
 		}
 
-		if (alpha < stand_pat) {
+		int old_alpha = alpha;
+		int best_move = NOMOVE;
+
+		if (alpha < stand_pat && !in_check) {
 			alpha = stand_pat;
 		}
 
 
 
 		int score = -INF;
-		
-		// If we're in check, we'll generate all moves, since we would otherwise give false mate scores if no captures were available to evade the check
-		// (~20 elo)
-		bool in_check = ss->pos->in_check();
 
 
 
-		// Step 3. Delta pruning (~10 elo). If our position is so bad that not even the best capture possible would be enough to raise alpha, we'll assume that it is an all-node.
+		// Step 4. Delta pruning (~10 elo). If our position is so bad that not even the best capture possible would be enough to raise alpha, we'll assume that it is an all-node.
 		//if (stand_pat + std::max(delta_margin, ss->pos->best_capture_possible()) <= alpha && !in_check) {
 		//	return alpha;
 		//}
 
 
-		// Step 4. Generation of moves
-		MoveStager stager(ss->pos);
+		// Step 5. Generation of moves
+		MoveStager stager(ss->pos, ttHit ? entry.get_move() : NOMOVE, in_check, use_qsearch_checks && depth == 0);
 
 		int legal = 0;
 		int move = NOMOVE;
@@ -1052,21 +1158,26 @@ namespace Search {
 		while(stager.next_move(current_move, true)) {
 			
 			move = current_move.move;
-			int piece_captured = ss->pos->piece_list[(ss->pos->side_to_move == WHITE) ? BLACK : WHITE][TOSQ(move)];
 
-			// Step 5. SEE pruning (~56 elo). If the move is a capture and SEE(move) < 0 (we know this if move->score < 0 for captures), just prune it.
-			if (piece_captured != NO_TYPE && current_move.score < 0) {
+			// Step 6. SEE pruning (~56 elo). If the move is a capture or quiet check and SEE(move) < 0 (we know this if move->score < 0 for these),
+			//	just prune it. Evasions are never scored below zero.
+			if (current_move.score < 0) {
 				continue;
 			}
 			
-			// Step 6. Futility pruning (~30 elo). If the value of the piece captured, plus some margin (~200cp) is still not enough to raise alpha, we won't bother searching it.
+			// Step 7. Futility pruning (~30 elo). If the value of the piece captured, plus some margin (~200cp) is still not enough to raise alpha, we won't bother searching it.
 			// We'll just have to make sure, that there has been tested at least one legal move, so we don't miss a checkmate
+			//int piece_captured = ss->pos->piece_list[(ss->pos->side_to_move == WHITE) ? BLACK : WHITE][TOSQ(move)];
 			//if (SPECIAL(move) != PROMOTION && SPECIAL(move) != ENPASSANT && piece_captured != NO_TYPE &&
 			//	stand_pat + delta_piece_value[piece_captured] + delta_margin <= alpha
 			//	&& !ss->pos->is_endgame()) {
 			//	continue;
 			//}
 
+			// The child probes the quiescence table, so start loading its bucket before making the move.
+			if (qtt != nullptr) {
+				qtt->prefetch(ss->pos->key_after(move));
+			}
 
 			if (!ss->pos->make_move(&current_move)) {
 				continue;
@@ -1074,7 +1185,7 @@ namespace Search {
 			legal++;
 
 
-			score = -quiescence(ss, -beta, -alpha);
+			score = -quiescence(ss, -beta, -alpha, depth - 1);
 
 			ss->pos->undo_move();
 
@@ -1088,15 +1199,28 @@ namespace Search {
 				}
 				ss->info->fh++;
 
+				if (qtt != nullptr) {
+					qtt->store_entry(ss->pos, move, value_to_tt(beta, ss->pos->ply), static_eval, qdepth, ttFlag::BETA);
+				}
 
 				return beta;
 			}
 
 			if (score > alpha) {
 				alpha = score;
+				best_move = move;
 			}
 		}
 
+		// Step 8. If we're in check and there are no legal evasions, we're mated.
+		if (in_check && legal == 0) {
+			return -INF + ss->pos->ply;
+		}
+
+		// Step 9. Store the result in the quiescence table. If alpha has been raised by a move, it is an exact score, otherwise an upper bound.
+		if (qtt != nullptr) {
+			qtt->store_entry(ss->pos, best_move, value_to_tt(alpha, ss->pos->ply), static_eval, qdepth, (alpha > old_alpha && best_move != NOMOVE) ? ttFlag::EXACT : ttFlag::ALPHA);
+		}
 
 		return alpha;
 	}
@@ -1156,6 +1280,9 @@ SearchInfo_t::SearchInfo_t(const SearchInfo_t& s) {
 
 	fh = s.fh;
 	fhf = s.fhf;
+
+	tt_stats = s.tt_stats;
+	eval_stats = s.eval_stats;
 }
 
 
@@ -1184,6 +1311,22 @@ long long getFailHigh() {
 	return n;
 }
 
+TT_Stats getTTStats() {
+	TT_Stats stats;
+	for (int i = 0; i < Search::threads->count(); i++) {
+		stats += (Search::threads->at(i))->info->tt_stats;
+	}
+	return stats;
+}
+
+EvalTable_Stats getEvalStats() {
+	EvalTable_Stats stats;
+	for (int i = 0; i < Search::threads->count(); i++) {
+		stats += (Search::threads->at(i))->eval->get_table_stats();
+	}
+	return stats;
+}
+
 long long getFailHighFirst() {
 	long long n = 0;
 	for (int i = 0; i < Search::threads->count(); i++) {
@@ -1201,7 +1344,7 @@ void uci_moveinfo(int move, int depth, int index) {
 
 
 int to_cp(int score) {
-	return score * (100 / pawn_value.mg);
+	return score * (100 / pawn_value.mg());
 }
 
 int to_mate(int score) {
@@ -1235,16 +1378,22 @@ void Search::INIT() {
 		}
 	}
 
-	// Initialize table of late move reductions
-	for (double d = 1; d < MAXDEPTH; d += 1.0) {
+	// Initialize table of late move reductions. The logarithms are computed once for each depth and move count instead of for every pair.
+	double log_2x[std::max(MAXDEPTH, MAXPOSITIONMOVES)] = { 0 };
+
+	for (int i = 1; i < std::max(MAXDEPTH, MAXPOSITIONMOVES); i++) {
+		log_2x[i] = std::log(2.0 * double(i));
+	}
+
+	for (int d = 1; d < MAXDEPTH; d++) {
 
-		for (double c = 1; c < MAXPOSITIONMOVES; c += 1.0) {
+		for (int c = 1; c < MAXPOSITIONMOVES; c++) {
 
 			//Reductions[(int)d][(int)c] = 1.75 + (int)std::round((std::log(3.0 * d) * std::log(3.0 * c)) / 5.5);
-			Reductions[(int)d][(int)c] = (int)std::round((std::log(2.0 * d) * std::log(2.0 * c)) / 5.5);
+			Reductions[d][c] = (int)std::round((log_2x[d] * log_2x[c]) / 5.5);
 
-			if (Reductions[(int)d][(int)c] < 1) {
-				Reductions[(int)d][(int)c] = 1;
+			if (Reductions[d][c] < 1) {
+				Reductions[d][c] = 1;
 			}
 
 		}
@@ -1274,7 +1423,7 @@ void Search::INIT() {
 		for (int lead = 0; lead < 2000; lead++) {
 			// This is set so as to not reduce by more than six plies under any circumstance
 			//NM_Reductions[d][lead] = ((d > 6) ? 3 : 2) + std::max(0, std::min(3, (int)std::round(1.5 * std::log(std::pow(lead / 100, 2)))));
-			NM_Reductions[d][lead] = (int)std::round(1.5 + 0.25 * double(d) + std::min(3.0, double(lead) / (2.0 * (double)pawn_value.mg)));
+			NM_Reductions[d][lead] = (int)std::round(1.5 + 0.25 * double(d) + std::min(3.0, double(lead) / (2.0 * (double)pawn_value.mg())));
 		}
 	}
 }
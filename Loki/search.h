@@ -19,6 +19,7 @@
 #define SEARCH_H
 #include "movegen.h"
 #include "misc.h"
+#include "numa.h"
 #include "movestager.h"
 
 #include "transposition.h"
@@ -52,6 +53,9 @@ namespace Search {
 
 	void runSearch(GameState_t* pos, SearchInfo_t* info, int num_threads);
 
+	// The threads are kept between searches. reset_threads deletes them, such that the next search allocates new ones.
+	void reset_threads();
+
 	// searchPosition is run on each thread and it is here iterative deepening will be done.
 	void searchPosition(SearchThread_t* ss);
 	
@@ -64,7 +68,8 @@ namespace Search {
 
 	int alphabeta(SearchThread_t* ss, int depth, int alpha, int beta, bool can_null, SearchPv* pvLine);
 
-	int quiescence(SearchThread_t* ss, int alpha, int beta);
+	// The depth is zero on the first ply of quiescence, and negative after that.
+	int quiescence(SearchThread_t* ss, int alpha, int beta, int depth = 0);
 
 	namespace Debug {
 		// MTDF is useful for debugging the transposition table as suggested by Tord Romstad on the WinBoard forum.
@@ -125,6 +130,8 @@ extern void ChangePV(int move, SearchPv* parent, SearchPv* child);
 extern long long getNodes();
 extern long long getFailHigh();
 extern long long getFailHighFirst();
+extern TT_Stats getTTStats();
+extern EvalTable_Stats getEvalStats();
 
 extern void uci_moveinfo(int move, int depth, int index);
 
@@ -37,6 +37,12 @@ Counter moves
 */
 constexpr int countermove_bonus = 70000;
 
+/*
+Threats
+*/
+// Quiet moves that take a threatened piece to a square not attacked by enemy pawns are ordered above quiets with equal history.
+constexpr int threat_escape_bonus = 8000;
+
 /*
 Captures
 */
@@ -72,6 +78,13 @@ constexpr bool use_razoring = true;
 constexpr int razoring_depth = 2;
 
 
+/*
+Quiescence checks
+*/
+// On the first ply of quiescence search, the quiet moves that give check are searched after the captures.
+constexpr bool use_qsearch_checks = true;
+
+
 /*
 Delta pruning
 */
@@ -173,7 +173,8 @@ Bitboard GameState_t::attackSlider(Bitboard occupied, int to_sq, SIDE side) cons
 
 /*
 
-Static Exchange Evaluation function. Computes the likely material gain/loss as a result of a capture.
+Static Exchange Evaluation function. Computes the likely material gain/loss as a result of a capture. For a quiet move the initial gain is zero,
+so the result is the material lost if the moved piece can be won on its new square.
 
 */
 
@@ -184,7 +185,7 @@ int GameState_t::see(unsigned int move) const {
 	Bitboard mayXray = 0, fromSet = 0, occupied = 0, attackers = 0;
 
 	assert(piece_on(from_sq, side_to_move) >= PAWN && piece_on(from_sq, side_to_move) <= KING);
-	assert(piece_on(to_sq, (side_to_move == WHITE) ? BLACK : WHITE) >= PAWN && piece_on(to_sq, (side_to_move == WHITE) ? BLACK : WHITE) < KING);
+	assert(piece_on(to_sq, (side_to_move == WHITE) ? BLACK : WHITE) != KING);
 
 	// If move is a special move
 	if (SPECIAL(move) == ENPASSANT) {
@@ -198,7 +199,9 @@ int GameState_t::see(unsigned int move) const {
 	occupied = all_pieces[WHITE] | all_pieces[BLACK]; // Set occupancy bitboard
 	attackers = attackers_to(to_sq, occupied);	// Find all attackers to the destination square.
 
-	gain[d] = see_pieces[piece_on(to_sq, (side_to_move == WHITE) ? BLACK : WHITE)]; // The initial gain is the piece captured.
+	// The initial gain is the piece captured, if any.
+	int captured = piece_on(to_sq, (side_to_move == WHITE) ? BLACK : WHITE);
+	gain[d] = (captured == NO_TYPE) ? 0 : see_pieces[captured];
 
 	mayXray = occupied ^ (pieceBBS[KNIGHT][WHITE] | pieceBBS[KNIGHT][BLACK] | pieceBBS[KING][WHITE] | pieceBBS[KING][BLACK]);
 
@@ -229,7 +232,7 @@ int GameState_t::see(unsigned int move) const {
 
 	} while (fromSet);
 
-	while (d--) {
+	while (--d) {
 		gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
 	}
 
@@ -171,8 +171,7 @@ namespace Texel {
 
 		// Step 1. Change the values in p with the ones in new_values
 		for (int i = 0; i < new_values.size(); i++) {
-			p[i].variable->mg = new_values[i].mg;
-			p[i].variable->eg = new_values[i].eg;
+			*p[i].variable = new_values[i];
 		}
 
 		// Step 2. Compute the new error and return
@@ -245,7 +244,7 @@ namespace Texel {
 		std::vector<Score> theta;
 
 		for (int p = 0; p < tuning_vars.size(); p++) {
-			theta.push_back(Score(tuning_vars[p].variable->mg, tuning_vars[p].variable->eg));
+			theta.push_back(*tuning_vars[p].variable);
 		}
 
 
@@ -344,8 +343,8 @@ namespace Texel {
 				// Step 5C.1. Compute theta_plus and theta_minus from these values
 				//theta_plus.push_back(Score(std::round(theta[p].mg + double(d_mg) * cn), std::round(theta[p].eg + double(d_eg) * cn)));
 				//theta_minus.push_back(Score(std::round(theta[p].mg - double(d_mg) * cn), std::round(theta[p].eg - double(d_eg) * cn)));
-				theta_plus.push_back(Score(std::round(theta[p].mg + double(d_mg) * cn[p].mg), std::round(theta[p].eg + double(d_eg) * cn[p].eg)));
-				theta_minus.push_back(Score(std::round(theta[p].mg - double(d_mg) * cn[p].mg), std::round(theta[p].eg - double(d_eg) * cn[p].eg)));
+				theta_plus.push_back(Score(std::round(theta[p].mg() + double(d_mg) * cn[p].mg), std::round(theta[p].eg() + double(d_eg) * cn[p].eg)));
+				theta_minus.push_back(Score(std::round(theta[p].mg() - double(d_mg) * cn[p].mg), std::round(theta[p].eg() - double(d_eg) * cn[p].eg)));
 			}
 
 			// Step 5D. Compute the error of theta_plus and theta_minus respectively.
@@ -361,27 +360,27 @@ namespace Texel {
 
 				//g_hat_mg = (theta_plus_error - theta_minus_error) / (2.0 * cn * double(delta[p].mg));
 				//g_hat_eg = (theta_plus_error - theta_minus_error) / (2.0 * cn * double(delta[p].eg));
-				g_hat_mg = (theta_plus_error - theta_minus_error) / (2.0 * cn[p].mg * double(delta[p].mg));
-				g_hat_eg = (theta_plus_error - theta_minus_error) / (2.0 * cn[p].eg * double(delta[p].eg));
+				g_hat_mg = (theta_plus_error - theta_minus_error) / (2.0 * cn[p].mg * double(delta[p].mg()));
+				g_hat_eg = (theta_plus_error - theta_minus_error) / (2.0 * cn[p].eg * double(delta[p].eg()));
 
 				// Now adjust the theta values based on the gradient.
 				//theta[p].mg -= std::round(an * g_hat_mg);
 				//theta[p].eg -= std::round(an * g_hat_eg);
 
-				theta[p].mg -= std::round(an[p].mg * g_hat_mg);
-				theta[p].eg -= std::round(an[p].eg * g_hat_eg);
+				int mg = theta[p].mg() - int(std::round(an[p].mg * g_hat_mg));
+				int eg = theta[p].eg() - int(std::round(an[p].eg * g_hat_eg));
 
 				// Lastly, we'll have to make sure that we don't go out of the designated bounds
-				theta[p].mg = std::max(tuning_vars[p].min_value.mg, std::min(tuning_vars[p].max_value.mg, theta[p].mg));
-				theta[p].eg = std::max(tuning_vars[p].min_value.eg, std::min(tuning_vars[p].max_value.eg, theta[p].eg));
+				theta[p] = Score(std::max(tuning_vars[p].min_value.mg(), std::min(tuning_vars[p].max_value.mg(), mg)),
+					std::max(tuning_vars[p].min_value.eg(), std::min(tuning_vars[p].max_value.eg(), eg)));
 			}
 
 			// Step 5F. Display the current values.
 			std::cout << "Values after " << (n + 1) << " iterations: " << std::endl;
 			
 			for (int p = 0; p < tuning_vars.size(); p++) {
-				std::cout << "[" << (p + 1) << "]: mg = " << theta[p].mg << ",	eg = " << theta[p].eg << ",		(Original: [" << tuning_vars[p].original_value.mg 
-					<< ", " << tuning_vars[p].original_value.eg << "])" << std::endl;
+				std::cout << "[" << (p + 1) << "]: mg = " << theta[p].mg() << ",	eg = " << theta[p].eg() << ",		(Original: [" << tuning_vars[p].original_value.mg() 
+					<< ", " << tuning_vars[p].original_value.eg() << "])" << std::endl;
 			}
 
 			std::cout << "\n\n";
@@ -439,19 +438,19 @@ namespace Texel {
 
 		// Step 3C.1. Write the middlegame gradient
 		outFile << "Gradient MG;";
-		outFile << data[0].gradient.mg;
+		outFile << data[0].gradient.mg();
 
 		for (int i = 1; i < data.size(); i++) {
-			outFile << ";" << data[i].gradient.mg;
+			outFile << ";" << data[i].gradient.mg();
 		}
 		outFile << "\n";
 
 		// Step 3C.1. Write the endgame gradient
 		outFile << "Gradient EG;";
-		outFile << data[0].gradient.eg;
+		outFile << data[0].gradient.eg();
 
 		for (int i = 1; i < data.size(); i++) {
-			outFile << ";" << data[i].gradient.eg;
+			outFile << ";" << data[i].gradient.eg();
 		}
 		outFile << "\n";
 
@@ -463,20 +462,20 @@ namespace Texel {
 
 			// Step 3D.1. Write middlegame data first.
 			outFile << "Variable " << (v + 1) << " MG;";
-			outFile << data[0].values[v].mg;
+			outFile << data[0].values[v].mg();
 
 			for (int i = 0; i < data.size(); i++) {
-				outFile << ";" << data[i].values[v].mg;
+				outFile << ";" << data[i].values[v].mg();
 			}
 			outFile << "\n";
 
 
 			// Step 3D.1. Write endgame data first.
 			outFile << "Variable " << (v + 1) << " EG;";
-			outFile << data[0].values[v].eg;
+			outFile << data[0].values[v].eg();
 
 			for (int i = 1; i < data.size(); i++) {
-				outFile << ";" << data[i].values[v].eg;
+				outFile << ";" << data[i].values[v].eg();
 			}
 			outFile << "\n";
 
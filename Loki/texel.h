@@ -94,7 +94,7 @@ namespace Texel {
 	*/
 	struct Parameter {
 
-		Parameter (Score* var, Value _rend = Value(0.002, 0.002), Value _cend = Value(4.0, 4.0), Score max_val = Score(INF, INF), Score min_val = Score(-INF, -INF)) {
+		Parameter (Score* var, Value _rend = Value(0.002, 0.002), Value _cend = Value(4.0, 4.0), Score max_val = Score(INT16_MAX, INT16_MAX), Score min_val = Score(-INT16_MAX, -INT16_MAX)) {
 			variable = var; // Copy the pointer
 
 			max_value = max_val;
@@ -16,6 +16,10 @@
 	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "thread.h"
+#include "numa.h"
+
+#include <thread>
+#include <vector>
 
 
 
@@ -43,6 +47,9 @@ void SearchInfo_t::clear() {
 
 	fh = 0;
 	fhf = 0;
+
+	tt_stats.clear();
+	eval_stats.clear();
 }
 
 
@@ -135,6 +142,7 @@ void SearchThread_t::clear_move_heuristics() {
 	for (int d = 0; d < MAXDEPTH; d++) {
 		stats.moves_path[d] = 0;
 		stats.static_eval[d] = 0;
+		stats.threats[d].mark_unknown();
 
 		stats.killers[d][0] = 0;
 		stats.killers[d][1] = 0;
@@ -143,6 +151,38 @@ void SearchThread_t::clear_move_heuristics() {
 
 
 
+/*
+
+Allocate the SearchThread_t objects. If NUMA support is enabled, each object is allocated by a thread bound to the same node as the search thread
+that will use it (see Numa::bind_thread), such that its move ordering tables and evaluation hash tables are first touched, and thereby placed, there.
+
+*/
+ThreadPool_t::ThreadPool_t(int num_threads) {
+	threadNum = num_threads;
+	threads = new SearchThread_t*[num_threads];
+
+	if (!Numa::enabled() || Numa::node_count() < 2) {
+		for (int i = 0; i < threadNum; i++) {
+			threads[i] = new SearchThread_t;
+		}
+		return;
+	}
+
+	std::vector<std::thread> allocators;
+	for (int i = 0; i < threadNum; i++) {
+		allocators.emplace_back([this, i]() {
+			Numa::bind_thread(i);
+			threads[i] = new SearchThread_t;
+		});
+	}
+
+	for (auto& a : allocators) {
+		a.join();
+	}
+}
+
+
+
 /*
 
 Initialize all the SearchThread_t objects.
@@ -151,9 +191,9 @@ Initialize all the SearchThread_t objects.
 void ThreadPool_t::init_threads(GameState_t* pos, SearchInfo_t* info) {
 
 	for (int i = 0; i < threadNum; i++) {
-		*threads[i].pos = *pos;
-		*threads[i].info = *info;
-		threads[i].thread_id = i;
+		*threads[i]->pos = *pos;
+		*threads[i]->info = *info;
+		threads[i]->thread_id = i;
 	}
 
 }
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include "movegen.h"
 #include "search_const.h"
 #include "evaluation.h"
+#include "tt_entry.h"
 
 
 
@@ -44,10 +45,17 @@ public:
 	int fh = 0;
 	int fhf = 0;
 
+	// Transposition table counters for this thread.
+	TT_Stats tt_stats;
+
+	// Evaluation hash table counters. Only set on the SearchInfo_t given to runSearch, where they're summed up for all threads after the search.
+	EvalTable_Stats eval_stats;
+
 	SearchInfo_t() {
 
 	}
 	SearchInfo_t(const SearchInfo_t& s);
+	SearchInfo_t& operator=(const SearchInfo_t& s) = default;
 
 	// Just set the values in the struct to the default.
 	void clear();
@@ -76,6 +84,9 @@ struct MoveStats_t {
 	// Static evaluations
 	int static_eval[MAXDEPTH + 1] = { 0 };
 
+	// The threats against the side to move at each ply. They are unknown (not valid) if the side to move is in check.
+	Eval::Threats_t threats[MAXDEPTH + 1];
+
 };
 
 
@@ -108,12 +119,12 @@ public:
 
 class ThreadPool_t {
 public:
-	ThreadPool_t(int num_threads) {
-		threads = new SearchThread_t[num_threads];
-		threadNum = num_threads;
-	}
+	ThreadPool_t(int num_threads);
 
 	~ThreadPool_t() {
+		for (int i = 0; i < threadNum; i++) {
+			delete threads[i];
+		}
 		delete[] threads;
 	}
 
@@ -121,7 +132,7 @@ public:
 
 	SearchThread_t* at(int index) {
 		if (index < threadNum) {
-			return &threads[index];
+			return threads[index];
 		}
 		else {
 			return nullptr;
@@ -133,7 +144,8 @@ public:
 	}
 
 private:
-	SearchThread_t* threads = nullptr;
+	// The threads are allocated separately, such that each of them can be placed on the NUMA node its search thread is bound to.
+	SearchThread_t** threads = nullptr;
 
 	int threadNum = 0;
 };
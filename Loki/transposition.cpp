@@ -16,31 +16,67 @@
 	along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "transposition.h"
+#include "misc.h"
+#include "numa.h"
+
+#include <climits>
+#include <new>
+#include <thread>
+#include <fstream>
+#include <sstream>
 
 
 TranspositionTable *tt = new TranspositionTable(TT_DEFAULT_SIZE);
+TranspositionTable *qtt = (QTT_DEFAULT_SIZE > 0) ? new TranspositionTable(QTT_DEFAULT_SIZE, "quiescence table") : nullptr;
 
 /// <summary>
 /// Default constructor for the transposition table.
 /// </summary>
 /// <param name="size">The size of the table in megabytes.</param>
-TranspositionTable::TranspositionTable(uint64_t size) {
-	uint64_t upperSize = MB(size) / sizeof(TT_Entry);
-	numEntries = nearest_power_two(upperSize); // numEntries should be a power of two.
-	num_slots = numEntries / 2;
-	
-	table = new TT_Slot[num_slots];
+/// <param name="table_name">The name used when printing info about the table.</param>
+TranspositionTable::TranspositionTable(uint64_t size, const std::string& table_name) : name(table_name) {
+	long long alloc_time = allocate(size);
+	long long clear_time = clear_table();
 
-	clear_table();
-
-	std::cout << "Initialized " << size << "MB (" << numEntries << " entries) " << " transposition table." << std::endl;
+	std::cout << "Initialized " << size << "MB (" << numEntries << " entries) " << " " << name << ". Allocation: " << alloc_time << "ms"
+		<< (huge_pages ? " (huge pages)" : "") << ", clear: " << clear_time << "ms." << std::endl;
 }
 
 /// <summary>
 /// Default destructor of the transposition table.
 /// </summary>
 TranspositionTable::~TranspositionTable() {
-	delete[] table;
+	wait();
+	large_page_free(table);
+}
+
+
+/// <summary>
+/// Allocate memory for the table. The old table (if any) is freed first. The new table is not cleared.
+/// </summary>
+/// <param name="size">The size of the table in megabytes.</param>
+/// <returns>The time spent allocating in milliseconds.</returns>
+long long TranspositionTable::allocate(uint64_t size) {
+	long long start = getTimeMs();
+
+	large_page_free(table);
+	table = nullptr;
+
+	uint64_t upperSize = MB(size) / sizeof(TT_Entry);
+	numEntries = nearest_power_two(upperSize); // numEntries should be a power of two.
+	num_buckets = std::max<size_t>(numEntries / BUCKET_SIZE, 1);
+
+	table = static_cast<TT_Bucket*>(large_page_alloc(num_buckets * sizeof(TT_Bucket), huge_pages));
+
+	if (table == nullptr) {
+		std::cerr << "Failed to allocate " << size << "MB for the transposition table." << std::endl;
+		throw std::bad_alloc();
+	}
+
+	// If enabled, spread the pages over all NUMA nodes. This must happen before clear_table touches the memory.
+	Numa::interleave(table, num_buckets * sizeof(TT_Bucket));
+
+	return getTimeMs() - start;
 }
 
 
@@ -50,7 +86,7 @@ TranspositionTable::~TranspositionTable() {
 /// </summary>
 /// <returns>The size of the transposition table in MB.</returns>
 size_t TranspositionTable::size() {
-	return ((numEntries * sizeof(TT_Entry)) >> 20) + 1;
+	return (numEntries * sizeof(TT_Entry) + MB(1) - 1) >> 20;
 }
 
 
@@ -59,107 +95,342 @@ size_t TranspositionTable::size() {
 /// </summary>
 /// <param name="size">The new size in MB</param>
 void TranspositionTable::resize(uint64_t size) {
-	delete[] table;
+	wait();
 
-	uint64_t upperSize = MB(size) / sizeof(TT_Entry);
-	numEntries = nearest_power_two(upperSize);
-	num_slots = numEntries / 2;
+	std::cout << "info string " << resize_table(size) << std::endl;
+}
 
-	table = new TT_Slot[num_slots];
 
-	clear_table();
+/// <summary>
+/// Allocate and clear the table with a new size. Nothing is printed, since this might run on the background thread.
+/// </summary>
+/// <param name="size">The new size in MB</param>
+/// <returns>A description of the resize to report to the GUI.</returns>
+std::string TranspositionTable::resize_table(uint64_t size) {
+	long long alloc_time = allocate(size);
+	long long clear_time = clear_table();
+
+	std::stringstream ss;
+	ss << "Resized " << name << " to " << size << "MB (" << numEntries << " entries). Allocation: " << alloc_time << "ms"
+		<< (huge_pages ? " (huge pages)" : "") << ", clear: " << clear_time << "ms.";
+
+	return ss.str();
+}
+
+
+/// <summary>
+/// Start resizing the table on a background thread. If another resize or clear is running, we'll wait for that to finish first.
+/// </summary>
+/// <param name="size">The new size in MB</param>
+void TranspositionTable::resize_async(uint64_t size) {
+	wait();
+
+	worker = std::thread([this, size]() {
+		report = resize_table(size);
+	});
+}
 
-	std::cout << "Resized transposition table to " << size << "MB (" << numEntries << " entries)." << std::endl;
+
+/// <summary>
+/// Start clearing the table on a background thread. If another resize or clear is running, we'll wait for that to finish first.
+/// </summary>
+void TranspositionTable::clear_async() {
+	wait();
+
+	worker = std::thread([this]() {
+		long long clear_time = clear_table();
+		report = "Cleared " + name + " in " + std::to_string(clear_time) + "ms";
+	});
 }
 
 
 /// <summary>
-/// Clear all entries in the transposition table.
+/// Wait for a background resize or clear to finish. The worker doesn't print anything itself, since that could interleave with the
+/// UCI thread's output (like readyok), so its report is printed here instead.
 /// </summary>
-void TranspositionTable::clear_table() {
+void TranspositionTable::wait() {
+	if (!worker.joinable()) {
+		return;
+	}
 
-	for (int i = 0; i < num_slots; i++) {
-		table[i].EntryOne.data.clear();
-		table[i].EntryTwo.data.clear();
+	worker.join();
+
+	if (!report.empty()) {
+		std::cout << "info string " << report << std::endl;
+		report.clear();
+	}
+}
+
+
+/// <summary>
+/// Clear all entries in the transposition table. The table is split into one chunk per thread, and the chunks are cleared in parallel.
+/// This is also where the memory is first touched after allocation, so each thread will fault in its own part of the table.
+/// </summary>
+/// <returns>The time spent clearing in milliseconds.</returns>
+long long TranspositionTable::clear_table() {
+	long long start = getTimeMs();
+
+	// Don't start a thread for less than 1MB of buckets, since starting it would take longer than clearing.
+	size_t thread_count = std::max<size_t>(1, std::min<size_t>(clear_threads, num_buckets / (MB(1) / sizeof(TT_Bucket))));
+	size_t chunk = num_buckets / thread_count;
+
+	auto clear_chunk = [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			new (&table[i]) TT_Bucket(); // TT_Entry's default member initializers zero the entries.
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t t = 1; t < thread_count; t++) {
+		workers.emplace_back(clear_chunk, t * chunk, (t == thread_count - 1) ? num_buckets : (t + 1) * chunk);
+	}
+
+	// The calling thread takes the first chunk.
+	clear_chunk(0, (thread_count == 1) ? num_buckets : chunk);
+
+	for (auto& w : workers) {
+		w.join();
 	}
 
 	generation = 0;
+
+	return getTimeMs() - start;
 }
 
 
-EntryData_t* TranspositionTable::probe_tt(uint64_t key, bool& hit) {
-	TT_Slot* slot = &table[key & (num_slots - 1)];
+/// <summary>
+/// Write the table to a file. The file consists of a FileHeader followed by the two words of every entry.
+/// </summary>
+/// <param name="path">The path of the file.</param>
+/// <returns>True if the table was saved.</returns>
+bool TranspositionTable::save(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
 
-#if defined(_WIN64) || defined(IS_64BIT) // Retrieve normally for 64-bit systems.
-	if (slot->EntryOne.data.get_key() == (key >> 48)) {
-		hit = true;
-		return &slot->EntryOne.data;
+	FileHeader header = { { 'L', 'O', 'K', 'I', '_', 'T', 'T', '\0' }, FILE_VERSION, uint32_t(sizeof(TT_Entry)), BBS::Zobrist::version_stamp(),
+		uint64_t(num_buckets), uint64_t(generation) };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	// Write one bucket at a time. Going through load() on the atomics avoids copying objects that may be written to concurrently.
+	uint64_t words[2 * BUCKET_SIZE];
+	for (size_t i = 0; i < num_buckets && file; i++) {
+		for (int j = 0; j < BUCKET_SIZE; j++) {
+			words[2 * j] = table[i].entries[j].key.load(std::memory_order_relaxed);
+			words[2 * j + 1] = table[i].entries[j].data.load(std::memory_order_relaxed);
+		}
+		file.write(reinterpret_cast<const char*>(words), sizeof(words));
 	}
-	else if (slot->EntryTwo.data.get_key() == (key >> 48)) {
-		hit = true;
-		return &slot->EntryTwo.data;
+
+	return bool(file);
+}
+
+
+/// <summary>
+/// Load a table saved with save(). The file is memory-mapped, so a large table is read at disk speed instead of being rebuilt by searching.
+/// If the file was saved with another table size, the entries are rehashed into the current table, which is possible since every entry holds
+/// the full position key (XOR'ed with the data).
+/// </summary>
+/// <param name="path">The path of the file.</param>
+/// <returns>True if the table was loaded.</returns>
+bool TranspositionTable::load(const std::string& path) {
+	size_t file_size = 0;
+	const char* mem = static_cast<const char*>(map_file(path, file_size));
+
+	if (mem == nullptr) {
+		return false;
 	}
-#else // For 32-bit systems we need to make sure the entry isn't corrupted by two threads reading/writing simultaneously.
-	
-	// Check the first entry.
-	uint64_t* data = slot->EntryOne.data.get_data();
-	if (slot->EntryOne.key == (key ^ *data)) { // Entry matches.
-		hit = true;
-		return &slot->EntryOne.data;
+
+	// Step 1. Validate the header. The keys have to be generated the same way, otherwise all entries would be garbage.
+	FileHeader header;
+	bool valid = file_size >= sizeof(header);
+
+	if (valid) {
+		std::memcpy(&header, mem, sizeof(header));
+
+		valid = std::memcmp(header.magic, "LOKI_TT", 8) == 0 && header.version == FILE_VERSION && header.entry_size == sizeof(TT_Entry)
+			&& header.zobrist_stamp == BBS::Zobrist::version_stamp()
+			&& file_size == sizeof(header) + header.num_buckets * BUCKET_SIZE * 2 * sizeof(uint64_t);
 	}
 
-	// Check the second entry.
-	data = slot->EntryTwo.data.get_data();
-	if (slot->EntryTwo.key == (key ^ *data)) {
-		hit = true;
-		return &slot->EntryTwo.data;
+	if (!valid) {
+		unmap_file(mem, file_size);
+		return false;
 	}
-#endif
 
-	hit = false;
-	return nullptr;
+	// Step 2. Insert all saved entries into the first free entry of their bucket. If the sizes match this reproduces the saved table exactly.
+	clear_table();
+
+	const char* words = mem + sizeof(header);
+	size_t saved_entries = header.num_buckets * BUCKET_SIZE;
+
+	for (size_t i = 0; i < saved_entries; i++) {
+		uint64_t key_word, data_word;
+		std::memcpy(&key_word, words + 16 * i, sizeof(uint64_t));
+		std::memcpy(&data_word, words + 16 * i + 8, sizeof(uint64_t));
+
+		if (data_word == 0) {
+			continue;
+		}
+
+		uint64_t pos_key = key_word ^ data_word;
+		TT_Bucket* bucket = &table[pos_key & (num_buckets - 1)];
+
+		for (int j = 0; j < BUCKET_SIZE; j++) {
+			if (!bucket->entries[j].occupied()) {
+				bucket->entries[j].write(pos_key, EntryData_t(data_word));
+				break;
+			}
+		}
+	}
+
+	generation = uint16_t(header.generation);
+
+	unmap_file(mem, file_size);
+	return true;
 }
 
 
-// For now we are just using a replace all strategy
-void TranspositionTable::store_entry(const GameState_t* pos, uint16_t move, int16_t score, uint16_t depth, uint16_t flag) {
-	TT_Slot* slot = &table[pos->posKey & (num_slots - 1)];
+/// <summary>
+/// Estimate how full the table is by counting the entries from the current search in the first 1000 entries.
+/// </summary>
+/// <returns>The amount of entries from the current search, in permille.</returns>
+int TranspositionTable::hashfull() const {
+	const size_t sample_buckets = std::min<size_t>(1000 / BUCKET_SIZE, num_buckets);
+	int count = 0;
+
+	for (size_t i = 0; i < sample_buckets; i++) {
+		for (int j = 0; j < BUCKET_SIZE; j++) {
+			const TT_Entry& e = table[i].entries[j];
+
+			if (e.occupied() && ((generation - e.peek().get_age()) & 127) == 0) {
+				count++;
+			}
+		}
+	}
 
-	// Step 1. Check if the data can be written to the first entry.
-	if (depth >= slot->EntryOne.data.get_depth() || depth == slot->EntryOne.data.get_depth() - 1 || generation > slot->EntryOne.data.get_age()) {
+	return int(count * 1000 / (sample_buckets * BUCKET_SIZE));
+}
 
-		// Step 1A. For 32-bit systems, get the data as a 64-bit integer.
-#if !(defined(_WIN64) || defined(IS_64BIT))
-		uint64_t* data = slot->EntryOne.data.get_data();
-#endif
 
-		// Step 1B. Write the new data.
-		// If generation has reached its limit (127), we'll subtract a random number from that so we'll be able to still replace later on.
-		slot->EntryOne.data.set(pos, move, score, depth, flag, (generation >= 127) ? generation - (pos->posKey & 1) : generation);
+/// <summary>
+/// Probe the transposition table for a position.
+/// </summary>
+/// <param name="key">The zobrist key of the position.</param>
+/// <param name="hit">A reference to a flag signalling if a valid entry was found.</param>
+/// <returns>A copy of the entry's data. This is only meaningful if hit is true.</returns>
+EntryData_t TranspositionTable::probe_tt(uint64_t key, bool& hit, TT_Stats* stats) {
+	TT_Bucket* bucket = &table[key & (num_buckets - 1)];
+	EntryData_t entry;
+	int rejected = 0;
+
+	// Step 1. Check all entries in the bucket. TT_Entry::read validates the data against the key, so a torn or foreign entry is never returned.
+	for (int i = 0; i < BUCKET_SIZE; i++) {
+		if (bucket->entries[i].read(key, entry)) {
+			if (stats != nullptr) {
+				stats->probes++;
+				stats->hits++;
+			}
+
+			hit = true;
+			return entry;
+		}
+
+		rejected += bucket->entries[i].occupied();
+	}
 
-		// Step 1C. For 32-bit systems, we need to save the position key XOR'd with the data in order to make the tt thread safe.
-#if !(defined(_WIN64) || defined(IS_64BIT))
-		slot->EntryOne.key = pos->posKey ^ *data;
-#endif
-		
-		// Return since we don't want to write the same position to both slots.
-		return;
+	// Step 2. Record the occupied entries that belonged to other positions, such that the pressure on the table can be monitored.
+	if (stats != nullptr) {
+		stats->probes++;
+		stats->occupied_misses += rejected;
 	}
 
-	// Step 2. If we can't populate the depth-preferred slot, write to the always replace one.
-	else {
-		// Step 2A. For 32-bit systems, get the data as a 64-bit integer.
-#if !(defined(_WIN64) || defined(IS_64BIT))
-		uint64_t* data = slot->EntryTwo.data.get_data();
-#endif
+	hit = false;
+	return entry;
+}
+
+
+/// <summary>
+/// Compute how valuable it is to keep an entry in the table. The entry with the lowest value in a bucket is the one to be replaced.
+/// Deep entries are worth more, entries from earlier searches are worth less and exact scores are preferred to bounds.
+/// </summary>
+/// <param name="data">The data of the entry.</param>
+/// <returns>The replacement value.</returns>
+int TranspositionTable::replace_value(const EntryData_t& data) const {
+	// The age is stored in seven bits, so the distance to the current generation is computed modulo 128.
+	int relative_age = (generation - data.get_age()) & 127;
+	int bound_bonus = (data.get_flag() == EXACT) ? 2 : (data.get_flag() == BETA) ? 1 : 0;
+
+	return data.get_depth() - 8 * relative_age + bound_bonus;
+}
 
-		// Step 2B. Write the data.
-		// Note: The generation doesn't matter here, so we'll just set it to 0.
-		slot->EntryTwo.data.set(pos, move, score, depth, flag, 0);
 
-		// Step 2C. For 32-bit systems, we need to save the position key XOR'd with the data in order to make the tt thread safe.
-#if !(defined(_WIN64) || defined(IS_64BIT))
-		slot->EntryTwo.key = pos->posKey ^ *data;
-#endif
+/// <summary>
+/// Store a position in the transposition table.
+/// </summary>
+/// <param name="pos">The position to store.</param>
+/// <param name="move">The best move found in the position.</param>
+/// <param name="score">The score of the position.</param>
+/// <param name="eval">The static evaluation of the position, or VALUE_NONE if it hasn't been computed.</param>
+/// <param name="depth">The depth the position was searched to.</param>
+/// <param name="flag">The kind of bound the score is.</param>
+/// <param name="stats">The counters of the calling thread. Optional.</param>
+void TranspositionTable::store_entry(const GameState_t* pos, uint16_t move, int16_t score, int eval, int depth, uint16_t flag, TT_Stats* stats) {
+	TT_Bucket* bucket = &table[pos->posKey & (num_buckets - 1)];
+	TT_Entry* replace = &bucket->entries[0];
+	uint64_t* store_path = nullptr;
+	EntryData_t old_data;
+	EntryData_t new_data;
+
+	// Step 1. Find the entry to overwrite.
+	int lowest_value = INT_MAX;
+	for (int i = 0; i < BUCKET_SIZE; i++) {
+		TT_Entry* e = &bucket->entries[i];
+
+		// Step 1A. If the position is already in the bucket, we'll overwrite it, unless the existing entry is a much deeper one from this search.
+		if (e->read(pos->posKey, old_data)) {
+			if (flag != EXACT && ((generation - old_data.get_age()) & 127) == 0 && depth + 2 < old_data.get_depth()) {
+				if (stats != nullptr) {
+					stats->stores_skipped++;
+				}
+				return;
+			}
+
+			// Don't throw away the old best move if we don't have a new one.
+			if (move == NOMOVE) {
+				move = old_data.get_move();
+			}
+
+			replace = e;
+			store_path = (stats != nullptr) ? &stats->stores_same : nullptr;
+			break;
+		}
+
+		// Step 1B. An empty entry is always the best candidate.
+		if (!e->occupied()) {
+			replace = e;
+			lowest_value = INT_MIN;
+			continue;
+		}
+
+		// Step 1C. Otherwise keep track of the least valuable entry.
+		int value = replace_value(e->peek());
+		if (value < lowest_value) {
+			lowest_value = value;
+			replace = e;
+		}
 	}
+
+	// Step 2. Record which path the store took. If it didn't hit the same position, it either used an empty entry or replaced another position.
+	if (stats != nullptr) {
+		if (store_path == nullptr) {
+			store_path = (lowest_value == INT_MIN) ? &stats->stores_empty : &stats->stores_replaced;
+		}
+		(*store_path)++;
+	}
+
+	// Step 3. Write the new data.
+	new_data.set(move, score, eval, depth, flag, generation);
+	replace->write(pos->posKey, new_data);
 }
\ No newline at end of file
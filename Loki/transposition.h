@@ -20,6 +20,9 @@
 #include "tt_entry.h"
 
 #include <vector>
+#include <atomic>
+#include <string>
+#include <thread>
 
 
 /// <summary>
@@ -45,53 +48,114 @@ inline uint64_t nearest_power_two(uint64_t maxSize) {
 /// </summary>
 class TranspositionTable {
 public:
-	TranspositionTable(uint64_t size);
+	TranspositionTable(uint64_t size, const std::string& table_name = "transposition table");
 
 	~TranspositionTable();
 
 	void resize(uint64_t size);
 
-	EntryData_t* probe_tt(const uint64_t key, bool& hit);
+	// Resize or clear the table on a background thread, such that the GUI doesn't have to wait for it. wait() must be called before the table
+	// is used again.
+	void resize_async(uint64_t size);
+	void clear_async();
 
-	void store_entry(const GameState_t* pos, uint16_t move, int16_t score, uint16_t depth,  uint16_t flag);
+	// Wait for a background resize or clear to finish, and print its report. This should only be called from the UCI thread, such that the
+	// report can't be interleaved with other output.
+	void wait();
+
+	EntryData_t probe_tt(const uint64_t key, bool& hit, TT_Stats* stats = nullptr);
+
+	// Prefetch the bucket of a position into the cache, such that a later probe or store doesn't have to wait for main memory.
+	void prefetch(uint64_t key) const {
+		::prefetch(&table[key & (num_buckets - 1)]);
+	}
+
+	void store_entry(const GameState_t* pos, uint16_t move, int16_t score, int eval, int depth, uint16_t flag, TT_Stats* stats = nullptr);
 
 	size_t size();
-	void clear_table();
+	long long clear_table();
+
+	// Save the table to a file, or load a previously saved one. Returns false (and leaves the table untouched) if something went wrong.
+	bool save(const std::string& path) const;
+	bool load(const std::string& path);
 
+	// Set the number of threads used to clear the table. This should follow the "Threads" UCI option.
+	void set_clear_threads(int n) {
+		wait();
+		clear_threads = std::max(1, n);
+	}
+
+	// Returns the permille of entries that have been written during the current search. Only a sample of the table is used.
+	int hashfull() const;
+
+	// The age is stored in 7 bits, so the generation wraps around at 128. Age distances are computed modulo 128 to match.
 	void setAge(int a) {
-		generation = std::min(a, 127);
+		generation = a & 127;
 	}
 	void increment_age() {
-		generation = std::min(generation + 1, 127); // We use 7 bits to store age information in the entries, and we shouldn't store anymore since they'd overflow.
-
-		if (generation >= 127) {
-			generation /= 2; // We need to increment the generation in games that are more than 127 moves.
-		}
+		generation = (generation + 1) & 127;
 	}
 	uint16_t getAge() {
 		return generation;
 	}
 
 private:
-	// Each slot in the transposition table holds two entries:
-	// 1st: Depth and age preferred replacement scheme.
-	// 2nd: Always replace.
-	struct TT_Slot {
-		TT_Entry EntryOne;
-		TT_Entry EntryTwo;
+	// The amount of entries in a bucket. Four 16-byte entries fill exactly one 64-byte cache line, so a probe never touches more than one line.
+	static constexpr int BUCKET_SIZE = 4;
+
+	// Each bucket in the transposition table holds BUCKET_SIZE entries. A position can be stored in any of them, and when the bucket is full,
+	// the entry with the lowest replacement value (see replace_value) is overwritten.
+	struct alignas(64) TT_Bucket {
+		TT_Entry entries[BUCKET_SIZE];
+	};
+
+	static_assert(sizeof(TT_Bucket) == 64, "A TT_Bucket should fill exactly one cache line.");
+
+	int replace_value(const EntryData_t& data) const;
+
+	long long allocate(uint64_t size);
+
+	// The header written in front of the entries when saving the table. If the layout of TT_Entry or EntryData_t changes, FILE_VERSION must be bumped.
+	static constexpr uint32_t FILE_VERSION = 3;
+
+	struct FileHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t entry_size;
+		uint64_t zobrist_stamp;
+		uint64_t num_buckets;
+		uint64_t generation;
 	};
 
-	TT_Slot* table = nullptr;
+	TT_Bucket* table = nullptr;
 
-	size_t num_slots = 0;
+	size_t num_buckets = 0;
 	size_t numEntries = 0;
 
 	uint16_t generation = 0;
+
+	int clear_threads = 1;
+	bool huge_pages = false;
+
+	// The name used when printing info about the table.
+	std::string name;
+
+	// The thread running a background resize or clear, if any.
+	std::thread worker;
+
+	// The message written by the worker when it is done. It is printed by wait() once the worker has been joined.
+	std::string report;
+
+	std::string resize_table(uint64_t size);
 };
 
 
 extern TranspositionTable *tt;
 
+// The quiescence search uses its own small table, such that the many quiescence nodes don't replace the deeper entries in tt. It should be small
+// enough to stay in the L2/L3 cache. This is nullptr if the table is disabled (QHash = 0).
+extern TranspositionTable *qtt;
+
 
 
 #endif
\ No newline at end of file
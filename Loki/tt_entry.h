@@ -19,6 +19,9 @@
 #define TT_ENTRY
 #include "position.h"
 
+#include <atomic>
+#include <cstring>
+
 
 /// <summary>
 /// Make the score of a position relative to the root in case of mate scores.
@@ -55,51 +58,138 @@ enum ttFlag :int { NO_FLAG = -1, ALPHA = 0, BETA = 1, EXACT = 2 };
 /// </summary>
 class EntryData_t {
 public:
-	void set(const GameState_t* pos, uint16_t _move, int16_t _score, uint16_t _depth, uint16_t _flag, uint16_t _age);
+	EntryData_t() { clear(); }
+	explicit EntryData_t(uint64_t raw) { std::memcpy(&data, &raw, sizeof(data)); }
+
+	void set(uint16_t _move, int16_t _score, int _eval, int _depth, uint16_t _flag, uint16_t _age);
 	void clear();
 
 	// Data retrieval getter methods.
-	uint16_t get_key() const { return data.key; }
+	int get_eval() const { return (data.eval == EVAL_NONE) ? VALUE_NONE : data.eval; }
 	uint16_t get_move() const { return data.move; }
 	int16_t get_score() const { return data.score; }
 	int8_t get_depth() const { return data.depth; }
-	int8_t get_flag() const { return data.flag; }
+	int get_flag() const { return int(data.flag) - 1; }
 	int8_t get_age() const { return data.age; }
 
-	// Function for expressing the data as a unsigned 64-bit integer. Used for 32-bit multithreading.
-	uint64_t* get_data() const { return (uint64_t*)&data; }
+	// Function for expressing the data as a unsigned 64-bit integer. This is what is actually stored in the table.
+	uint64_t get_data() const {
+		uint64_t raw = 0;
+		std::memcpy(&raw, &data, sizeof(raw));
+		return raw;
+	}
 private:
-	// The data is made to fit into a single 64 bit register.
-	// Note: This means that it has to be handled differently on 32-bit systems when using multiple threads.
+	// The static evaluation is stored in 16 bits, so VALUE_NONE is represented by EVAL_NONE.
+	static constexpr int16_t EVAL_NONE = INT16_MIN;
+
+	// The flag is stored plus one, such that NO_FLAG is 0 and every entry written with a real bound has a non-zero flag. This means that the
+	//	data of a stored entry is never zero, which TT_Entry::occupied relies on.
+	static constexpr uint16_t FLAG_OFFSET = 1;
+
+	// The data is made to fit into a single 64 bit register. It is validated with the full position key (see TT_Entry), so there's no need to
+	// keep a part of the key in here. That space is used for the static evaluation of the position instead.
 	struct data_t {
-		uint16_t key;
+		int16_t eval;
 		uint16_t move;
 		int16_t score;
-		int16_t depth : 7, flag : 2, age : 7;
+		int16_t depth : 7;
+		uint16_t flag : 2, age : 7; // Unsigned, such that EXACT (2) and ages above 63 read back as stored.
 	};
 	data_t data;
+
+	static_assert(sizeof(data_t) == sizeof(uint64_t), "EntryData_t::data_t must fit in 64 bits.");
 };
 
 
 
 /// <summary>
-/// TT_Entry is the structure for a single entry inside the TT bucket. This is responsible for handling data differently between 32-bit and 64-bit systems.
+/// TT_Entry is the structure for a single entry inside the TT bucket. It is shared between all search threads without any locks, so it has to
+/// handle two threads reading and writing the same entry simultaneously.
+/// This is done by storing the position key XOR'ed with the data (lockless hashing, as described by Hyatt and Mann). If another thread has overwritten
+/// only one of the two words, or the entry belongs to another position, key ^ data won't reproduce the probing position's key and the entry is rejected.
+/// Both words are relaxed atomics such that each of them is always loaded and stored as a whole, also on 32-bit systems.
 /// </summary>
 struct TT_Entry {
-#if defined(_WIN64) || defined(IS_64BIT)
-	EntryData_t data;
-#else
-	// For 32-bit systems we need to hold an extra 64-bit key in order to make multithreading possible.
-	uint64_t key = 0;
-	EntryData_t data;
-#endif
+	std::atomic<uint64_t> key{ 0 };
+	std::atomic<uint64_t> data{ 0 };
+
+	/// <summary>
+	/// Read the entry and validate it against a position key.
+	/// </summary>
+	/// <param name="pos_key">The zobrist key of the position we're probing for.</param>
+	/// <param name="out">The data of the entry. Only populated if the entry is valid.</param>
+	/// <returns>True if the entry belongs to the position and hasn't been torn by a concurrent write.</returns>
+	bool read(uint64_t pos_key, EntryData_t& out) const {
+		uint64_t raw = data.load(std::memory_order_relaxed);
+
+		if ((key.load(std::memory_order_relaxed) ^ raw) != pos_key) {
+			return false;
+		}
+
+		out = EntryData_t(raw);
+		return true;
+	}
+
+	/// <summary>
+	/// Read the data of the entry without validating it. Only used for replacement decisions, where a torn entry does no harm.
+	/// </summary>
+	EntryData_t peek() const {
+		return EntryData_t(data.load(std::memory_order_relaxed));
+	}
+
+	/// <summary>
+	/// Returns true if anything has been written to the entry since it was last cleared. Since the flag of a stored entry is never NO_FLAG, its
+	/// data is never zero (see EntryData_t), so an all-zero word always means an empty entry.
+	/// </summary>
+	bool occupied() const {
+		return data.load(std::memory_order_relaxed) != 0;
+	}
+
+	void write(uint64_t pos_key, const EntryData_t& d) {
+		uint64_t raw = d.get_data();
+
+		key.store(pos_key ^ raw, std::memory_order_relaxed);
+		data.store(raw, std::memory_order_relaxed);
+	}
+
+	void clear() {
+		key.store(0, std::memory_order_relaxed);
+		data.store(0, std::memory_order_relaxed);
+	}
 };
 
 
 
-
-
-
+/// <summary>
+/// TT_Stats holds the transposition table counters of a single search thread. They are kept per thread such that counting doesn't make the
+/// threads fight over shared cache lines, and they are summed up when reported.
+/// </summary>
+struct TT_Stats {
+	uint64_t probes = 0;
+	uint64_t hits = 0;
+	uint64_t cutoffs = 0;
+	uint64_t occupied_misses = 0; // Occupied entries in the probed bucket that didn't hold the position. These are other positions with the same index, and in rare cases entries torn by a concurrent write.
+
+	// Stores, by the path through the replacement scheme.
+	uint64_t stores_same = 0;		// The position was already in the bucket and has been updated.
+	uint64_t stores_skipped = 0;	// The position was already in the bucket with a deeper entry, so nothing was written.
+	uint64_t stores_empty = 0;		// The position was written to an empty entry.
+	uint64_t stores_replaced = 0;	// Another position has been overwritten.
+
+	void clear() { *this = TT_Stats(); }
+
+	TT_Stats& operator+=(const TT_Stats& other) {
+		probes += other.probes;
+		hits += other.hits;
+		cutoffs += other.cutoffs;
+		occupied_misses += other.occupied_misses;
+		stores_same += other.stores_same;
+		stores_skipped += other.stores_skipped;
+		stores_empty += other.stores_empty;
+		stores_replaced += other.stores_replaced;
+		return *this;
+	}
+};
 
 
 
@@ -32,6 +32,16 @@ void UCI::print_info() {
 	// Step 3C.1. Output all ajustible options for Loki.
 	std::cout << "option name Hash type spin default " << TT_DEFAULT_SIZE << " min " << TT_MIN_SIZE << " max " << TT_MAX_SIZE << std::endl;
 	std::cout << "option name Threads type spin default " << THREADS_DEFAULT_NUM << " min " << THREADS_MIN_NUM << " max " << THREADS_MAX_NUM << std::endl;
+	std::cout << "option name QHash type spin default " << QTT_DEFAULT_SIZE << " min " << QTT_MIN_SIZE << " max " << QTT_MAX_SIZE << std::endl;
+	std::cout << "option name EvalHash type spin default " << EVAL_TABLE_DEFAULT_SIZE << " min " << EVAL_TABLE_MIN_SIZE << " max " << EVAL_TABLE_MAX_SIZE << std::endl;
+	std::cout << "option name EvalHashShared type check default false" << std::endl;
+	std::cout << "option name NUMA type check default false" << std::endl;
+	std::cout << "option name EvalFile type string default <empty>" << std::endl;
+	std::cout << "option name UseNNUE type check default false" << std::endl;
+	std::cout << "option name HashFile type string default <empty>" << std::endl;
+	std::cout << "option name SaveHash type button" << std::endl;
+	std::cout << "option name LoadHash type button" << std::endl;
+	std::cout << "option name SliderAttacks type combo default " << Magics::backend_name(Magics::backend) << " var Magic var PEXT" << std::endl;
 	std::cout << "uciok" << std::endl;
 }
 
@@ -55,6 +65,9 @@ void UCI::loop() {
 		tt->resize(uint64_t(TT_DEFAULT_SIZE));
 	}
 	int mb = TT_DEFAULT_SIZE; // The set size for the transposition table.
+	std::string hash_file = ""; // The file the transposition table is saved to/loaded from.
+	int eval_mb = EVAL_TABLE_DEFAULT_SIZE; // The size of the evaluation hash table(s).
+	bool eval_shared = false; // Whether or not all threads share one evaluation hash table.
 
 	// Step 3. Begin listening for GUI-commands
 	std::string input;
@@ -67,13 +80,89 @@ void UCI::loop() {
 
 		// Step 3B. If we're told to start a new game, clear the transposition table and set up the starting position
 		if (input.find(std::string("ucinewgame")) != std::string::npos) {
-			tt->clear_table();
+			// The tables are cleared in the background. isready and go will wait for them to finish.
+			tt->clear_async();
+
+			if (qtt != nullptr) {
+				qtt->clear_async();
+			}
 
 			pos->parseFen(START_FEN);
 
 			continue;
 		}
 
+		// Step 3B.1. Options for saving the transposition table to a file and loading it again. These are checked before the other commands, since
+		//	the file path might contain words like "uci" or "go".
+		else if (input.find(std::string("setoption name HashFile value ")) != std::string::npos) {
+			hash_file = input.substr(input.find("value ") + 6);
+
+			if (hash_file == "<empty>") {
+				hash_file = "";
+			}
+			continue;
+		}
+
+		else if (input.find(std::string("setoption name SaveHash")) != std::string::npos) {
+			tt->wait();
+			long long start = getTimeMs();
+
+			if (hash_file != "" && tt->save(hash_file)) {
+				std::cout << "info string Saved transposition table to " << hash_file << " in " << (getTimeMs() - start) << "ms" << std::endl;
+			}
+			else {
+				std::cout << "info string Failed to save transposition table to '" << hash_file << "'" << std::endl;
+			}
+			continue;
+		}
+
+		else if (input.find(std::string("setoption name LoadHash")) != std::string::npos) {
+			tt->wait();
+			long long start = getTimeMs();
+
+			if (hash_file != "" && tt->load(hash_file)) {
+				std::cout << "info string Loaded transposition table from " << hash_file << " in " << (getTimeMs() - start) << "ms" << std::endl;
+			}
+			else {
+				std::cout << "info string Failed to load transposition table from '" << hash_file << "'" << std::endl;
+			}
+			continue;
+		}
+
+		// Step 3B.2. Options for the neural network evaluation. The file is loaded right away, such that the GUI is told if it failed.
+		else if (input.find(std::string("setoption name EvalFile value ")) != std::string::npos) {
+			std::string eval_file = input.substr(input.find("value ") + 6);
+
+			if (eval_file != "<empty>") {
+				if (NNUE::load(eval_file)) {
+					std::cout << "info string Loaded network from " << eval_file << std::endl;
+				}
+				else {
+					std::cout << "info string Failed to load network from '" << eval_file << "'" << std::endl;
+				}
+			}
+			continue;
+		}
+
+		else if (input.find(std::string("setoption name UseNNUE value ")) != std::string::npos) {
+			NNUE::set_enabled(input.find("true") != std::string::npos);
+
+			std::cout << "info string NNUE evaluation " << (NNUE::active ? "enabled" : "disabled") << std::endl;
+			continue;
+		}
+
+		// If we're told to index the slider attacks differently, the attack tables have to be rebuilt.
+		else if (input.find(std::string("setoption name SliderAttacks value ")) != std::string::npos) {
+			Magics::Backend requested = (input.find("PEXT") != std::string::npos) ? Magics::PEXT : Magics::MAGIC;
+
+			if (!Magics::set_backend(requested)) {
+				std::cout << "info string " << Magics::backend_name(requested) << " slider attacks are not available on this build or CPU" << std::endl;
+			}
+
+			std::cout << "info string Using " << Magics::backend_name(Magics::backend) << " slider attacks" << std::endl;
+			continue;
+		}
+
 		// Step 3C. If we are given a "uci" command, we should output all uci parameters and info of Loki.
 		else if (input.find(std::string("uci")) != std::string::npos) {
 
@@ -84,7 +173,13 @@ void UCI::loop() {
 		}
 
 		// Step 3D. When the GUI sends the "isready" command, Loki needs to signify that it is ready to take commands
+		//	If the transposition table is being resized or cleared in the background, we're not ready before that is done.
 		else if (input.find(std::string("isready")) != std::string::npos) {
+			tt->wait();
+
+			if (qtt != nullptr) {
+				qtt->wait();
+			}
 			std::cout << "readyok" << std::endl;
 			continue;
 		}
@@ -100,8 +195,54 @@ void UCI::loop() {
 			// Step 3E.2. Make sure the size is inside of the TT-size bounds
 			mb = std::min(TT_MAX_SIZE, std::max(TT_MIN_SIZE, mb));
 
-			// Step 3E.3. Finally, resize the transposition table.
-			tt->resize(uint64_t(mb));
+			// Step 3E.3. Finally, resize the transposition table. This is done in the background, and isready and go will wait for it to finish.
+			tt->resize_async(uint64_t(mb));
+
+			continue;
+		}
+
+
+		// If we're told to change the size of the quiescence table, do so. A size of 0 disables it.
+		else if (input.find(std::string("setoption name QHash value ")) != std::string::npos) {
+			std::stringstream strm(input);
+			std::string unused[4];
+			int qmb = QTT_DEFAULT_SIZE;
+			strm >> unused[0] >> unused[1] >> unused[2] >> unused[3] >> qmb;
+
+			qmb = std::min(QTT_MAX_SIZE, std::max(QTT_MIN_SIZE, qmb));
+
+			if (qtt != nullptr) {
+				qtt->wait();
+				delete qtt;
+				qtt = nullptr;
+			}
+
+			if (qmb > 0) {
+				qtt = new TranspositionTable(uint64_t(qmb), "quiescence table");
+			}
+
+			continue;
+		}
+
+
+		// If we're told to change the size of the evaluation hash table, or to switch between shared and per-thread tables, do so.
+		// The tables are (re)allocated when the next search starts.
+		else if (input.find(std::string("setoption name EvalHash value ")) != std::string::npos) {
+			std::stringstream strm(input);
+			std::string unused[4];
+			strm >> unused[0] >> unused[1] >> unused[2] >> unused[3] >> eval_mb;
+
+			eval_mb = std::min(EVAL_TABLE_MAX_SIZE, std::max(EVAL_TABLE_MIN_SIZE, eval_mb));
+			Eval::set_table_options(eval_mb, eval_shared);
+			Search::reset_threads();
+
+			continue;
+		}
+
+		else if (input.find(std::string("setoption name EvalHashShared value ")) != std::string::npos) {
+			eval_shared = (input.find("true") != std::string::npos);
+			Eval::set_table_options(eval_mb, eval_shared);
+			Search::reset_threads();
 
 			continue;
 		}
@@ -117,6 +258,24 @@ void UCI::loop() {
 			// Step 3F.2. Make sure the number of threads does not exceed the minimum/maximum number.
 			num_threads = std::min(THREADS_MAX_NUM, std::max(THREADS_MIN_NUM, num_threads));
 
+			// Step 3F.3. Let the transposition table use the same threads when clearing.
+			tt->set_clear_threads(num_threads);
+
+			continue;
+		}
+
+		// If we are told to enable or disable NUMA support, do so. The transposition table is reallocated, such that its pages get interleaved (or not) across the nodes.
+		//	With a single node, or if the setting didn't change, there is nothing to move.
+		else if (input.find(std::string("setoption name NUMA value ")) != std::string::npos) {
+			bool was_enabled = Numa::enabled();
+			Numa::set_enabled(input.find("true") != std::string::npos);
+
+			if (Numa::node_count() > 1 && Numa::enabled() != was_enabled) {
+				tt->resize_async(uint64_t(mb));
+				Search::reset_threads();
+			}
+
+			std::cout << "info string NUMA " << (Numa::enabled() ? "enabled" : "disabled") << " with " << Numa::node_count() << " node(s)" << std::endl;
 			continue;
 		}
 
@@ -149,6 +308,7 @@ void UCI::loop() {
 		}
 
 		else if (input.find(std::string("probetable")) != std::string::npos) { // Print the hash-entry for the position
+			tt->wait();
 			printHashEntry(pos);
 			continue;
 		}
@@ -165,6 +325,7 @@ void UCI::loop() {
 
 		// Step 3J. If we receive a "bench", run a benchmark node-count measurement
 		else if (input.find("bench") != std::string::npos) {
+			tt->wait();
 			Bench::run_benchmark();
 			continue;
 		}
@@ -373,16 +534,17 @@ printHashEntry is a helper function for displaying the hash entry for the curren
 void UCI::printHashEntry(GameState_t* pos) {
 	bool ttHit = false;
 
-	EntryData_t* entry = tt->probe_tt(pos->posKey, ttHit);
+	EntryData_t entry = tt->probe_tt(pos->posKey, ttHit);
 
 	if (ttHit) {
 		pos->displayBoardState();
 
 		std::cout << "TT entry info:" << std::endl;
-		std::cout << "Move:		" << printMove(entry->get_move()) << std::endl;
-		std::cout << "Score:	" << entry->get_score() << std::endl;
-		std::cout << "Depth:	" << entry->get_depth() << std::endl;
-		std::cout << "Flag:		" << (entry->get_flag() == ttFlag::EXACT ? "EXACT" : ((entry->get_flag() == ttFlag::BETA) ? "BETA" : "ALPHA")) << std::endl;
+		std::cout << "Move:		" << printMove(entry.get_move()) << std::endl;
+		std::cout << "Score:	" << entry.get_score() << std::endl;
+		std::cout << "Eval:		" << ((entry.get_eval() == VALUE_NONE) ? std::string("none") : std::to_string(entry.get_eval())) << std::endl;
+		std::cout << "Depth:	" << entry.get_depth() << std::endl;
+		std::cout << "Flag:		" << (entry.get_flag() == ttFlag::EXACT ? "EXACT" : ((entry.get_flag() == ttFlag::BETA) ? "BETA" : "ALPHA")) << std::endl;
 	}
 	else {
 		std::cout << "Position is not stored in transposition table" << std::endl;